@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../src/mig_rewriter.h"
+#include "../src/mig_structure.h"
+#include "../src/mig_synthesizer.h"
+#include "../src/npn_classifier.h"
+#include "../src/npn_matcher.h"
+#include "../src/truth_table.h"
+
+// Microbenchmarks for the core kernels.
+//
+//   benchmark [--filter s] [--repetitions r] [--json out.json]
+//             [--baseline old.json] [--threshold pct]
+//   benchmark --compare old.json new.json [--threshold pct]
+//
+// Every benchmark runs over a fixed corpus (seeded generator), once to warm
+// up and then r timed times (slow ones: 3 timed runs, no warm-up); the
+// report gives ns/op as mean, standard deviation and minimum over the
+// timed runs. With --baseline (or --compare),
+// a benchmark whose mean grew by more than the threshold (default 10%) is a
+// regression and the exit status is 1.
+
+namespace {
+
+// Timed runs of a slow benchmark, which gets no warm-up run
+constexpr int kSlowRepetitions = 3;
+
+struct Benchmark {
+    std::string name;
+    size_t ops;                     // operations per run
+    bool slow;                      // only run when selected by --filter
+    std::function<uint64_t()> run;  // result folded into a sink
+    std::function<void()> prepare = {};  // untimed setup before the first run, optional
+};
+
+struct Measurement {
+    std::string name;
+    size_t ops = 0;
+    int repetitions = 0;
+    double mean_ns = 0;
+    double stddev_ns = 0;
+    double min_ns = 0;
+};
+
+volatile uint64_t sink;
+
+std::vector<std::string> randomTables(int n_vars, size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::string> tables;
+    for (size_t i = 0; i < count; ++i) {
+        std::string tt(1 << n_vars, '0');
+        for (auto& c : tt) c = '0' + (rng() & 1);
+        tables.push_back(tt);
+    }
+    return tables;
+}
+
+// Random 4-input MIGs of 8 gates, each fanin drawn from the earlier nodes
+std::vector<MIG> randomMIGs(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<MIG> migs;
+    for (size_t i = 0; i < count; ++i) {
+        MIG mig(4);
+        for (int g = 0; g < 8; ++g) {
+            int nodes = 5 + g;
+            int gate = mig.addGate({int(rng() % nodes), int(rng() % nodes), int(rng() % nodes)},
+                                   {int(rng() & 1), int(rng() & 1), int(rng() & 1)});
+            mig.setOutput(gate, rng() & 1);
+        }
+        migs.push_back(mig);
+    }
+    return migs;
+}
+
+std::vector<Benchmark> makeBenchmarks() {
+    std::vector<Benchmark> benchmarks;
+
+    auto tables6 = std::make_shared<std::vector<std::string>>(randomTables(6, 4096, 1));
+    std::vector<uint64_t> packed6;
+    for (const auto& tt : *tables6) packed6.push_back(TruthTable::truthTableToBinary(tt));
+    auto packed = std::make_shared<std::vector<uint64_t>>(packed6);
+
+    benchmarks.push_back({"truth_table.to_binary", tables6->size(), false, [tables6]() {
+        uint64_t acc = 0;
+        for (const auto& tt : *tables6) acc += TruthTable::truthTableToBinary(tt);
+        return acc;
+    }});
+    benchmarks.push_back({"truth_table.from_binary", packed->size(), false, [packed]() {
+        uint64_t acc = 0;
+        for (uint64_t tt : *packed) acc += TruthTable::binaryToTruthTable(tt, 6)[17];
+        return acc;
+    }});
+    benchmarks.push_back({"truth_table.cofactor", tables6->size(), false, [tables6]() {
+        uint64_t acc = 0;
+        for (const auto& tt : *tables6) acc += TruthTable::getCofactor(tt, 2, 1)[5];
+        return acc;
+    }});
+    benchmarks.push_back({"truth_table.cofactor_packed", packed->size() * 6, false, [packed]() {
+        uint64_t acc = 0;
+        for (uint64_t tt : *packed) {
+            for (int v = 0; v < 6; ++v) acc += TruthTable::getCofactorPacked(tt, 6, v, v & 1);
+        }
+        return acc;
+    }});
+
+    auto wide = std::make_shared<std::vector<WideTruthTable>>();
+    for (const auto& tt : randomTables(12, 16, 2)) wide->push_back(WideTruthTable::fromString(tt));
+    benchmarks.push_back({"npn.semi_canonical_n12", wide->size(), false, [wide]() {
+        uint64_t acc = 0;
+        for (const auto& tt : *wide) acc += NPNClassifier::semiCanonicalHash(tt);
+        return acc;
+    }});
+
+    // Exact canonization: every 3-input function, samples of the larger spaces
+    const size_t npn_counts[] = {256, 256, 16};
+    for (int n = 3; n <= 5; ++n) {
+        std::shared_ptr<std::vector<std::string>> corpus;
+        if (n == 3) {
+            corpus = std::make_shared<std::vector<std::string>>(TruthTable::generateAllTruthTables(3));
+        } else {
+            corpus = std::make_shared<std::vector<std::string>>(randomTables(n, npn_counts[n - 3], 3 + n));
+        }
+        benchmarks.push_back({"npn.representative_n" + std::to_string(n), corpus->size(), false,
+                              [corpus]() {
+            uint64_t acc = 0;
+            for (const auto& tt : *corpus) acc += NPNClassifier::getNPNRepresentative(tt)[1];
+            return acc;
+        }});
+    }
+
+    // Matching random tables against random NPN transforms of themselves
+    for (int n = 4; n <= 6; ++n) {
+        auto pairs = std::make_shared<std::vector<std::pair<uint64_t, uint64_t>>>();
+        std::mt19937_64 rng(20 + n);
+        for (const auto& tt : randomTables(n, 1024, 10 + n)) {
+            std::vector<int> perm(n), neg(n);
+            for (int v = 0; v < n; ++v) {
+                perm[v] = v;
+                neg[v] = rng() & 1;
+            }
+            std::shuffle(perm.begin(), perm.end(), rng);
+            std::string moved = NPNClassifier::applyNegationPattern(
+                NPNClassifier::applyPermutation(tt, perm), neg, rng() & 1);
+            pairs->push_back({TruthTable::truthTableToBinary(tt), TruthTable::truthTableToBinary(moved)});
+        }
+        benchmarks.push_back({"npn.match_n" + std::to_string(n), pairs->size(), false, [pairs, n]() {
+            uint64_t acc = 0;
+            NPNTransform transform;
+            for (const auto& pair : *pairs) acc += NPNMatcher::match(pair.first, pair.second, n, transform);
+            return acc;
+        }});
+    }
+
+    auto migs = std::make_shared<std::vector<MIG>>(randomMIGs(1024, 4));
+    benchmarks.push_back({"mig.simulate", migs->size(), false, [migs]() {
+        uint64_t acc = 0;
+        for (const auto& mig : *migs) acc += mig.getTruthTable()[3];
+        return acc;
+    }});
+
+    // Depth rewriting of a deep 16-input graph, per gate; each gate draws
+    // its fanins from the 50 nodes before it
+    auto deep = std::make_shared<MIG>(16);
+    {
+        std::mt19937_64 rng(6);
+        for (int g = 0; g < 20000; ++g) {
+            int nodes = 17 + g;
+            auto pick = [&]() { return int(std::max(1, nodes - 50) + rng() % std::min(50, nodes - 1)); };
+            deep->addGate({pick(), pick(), pick()}, {int(rng() & 1), int(rng() & 1), int(rng() & 1)});
+        }
+        deep->setOutput(deep->n_vars + deep->size(), 0);
+    }
+    benchmarks.push_back({"mig.depth_rewrite", size_t(deep->size()), false, [deep]() {
+        MIG mig = *deep;
+        MIGRewriter::optimizeDepth(mig);
+        return uint64_t(mig.depth());
+    }});
+
+    // Exact synthesis of all 222 4-input classes takes tens of minutes, so it
+    // only runs when asked for by name. Classifying all 65536 functions takes
+    // about 50 ms, so the class list is built once, untimed, when selected.
+    auto classes = std::make_shared<std::vector<std::string>>();
+    benchmarks.push_back({"synthesis.optimal_n4_classes", 222, true,
+        [classes]() {
+            uint64_t acc = 0;
+            for (const auto& tt : *classes) {
+                auto mig = synthesizeOptimalMIG(tt);
+                acc += mig ? mig->size() : 0;
+            }
+            return acc;
+        },
+        [classes]() { *classes = NPNClassifier::findNPNClasses(TruthTable::generateAllTruthTables(4)); }});
+    return benchmarks;
+}
+
+Measurement measure(const Benchmark& benchmark, int repetitions) {
+    Measurement m;
+    m.name = benchmark.name;
+    m.ops = benchmark.ops;
+    m.repetitions = benchmark.slow ? kSlowRepetitions : repetitions;
+
+    std::vector<double> samples;
+    if (benchmark.prepare) benchmark.prepare();
+    if (!benchmark.slow) sink = benchmark.run();
+    for (int r = 0; r < m.repetitions; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        sink = benchmark.run();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        samples.push_back(ns / benchmark.ops);
+    }
+
+    for (double s : samples) m.mean_ns += s;
+    m.mean_ns /= samples.size();
+    for (double s : samples) m.stddev_ns += (s - m.mean_ns) * (s - m.mean_ns);
+    m.stddev_ns = samples.size() > 1 ? std::sqrt(m.stddev_ns / (samples.size() - 1)) : 0;
+    m.min_ns = *std::min_element(samples.begin(), samples.end());
+    return m;
+}
+
+// One benchmark per line, so that readReport does not need a JSON parser
+std::string toJson(const std::vector<Measurement>& results) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    out << "{\n  \"unit\": \"ns/op\",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& m = results[i];
+        out << "    {\"name\": \"" << m.name << "\", \"ops\": " << m.ops
+            << ", \"repetitions\": " << m.repetitions << ", \"mean\": " << m.mean_ns
+            << ", \"stddev\": " << m.stddev_ns << ", \"min\": " << m.min_ns << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return out.str();
+}
+
+double numberField(const std::string& line, const std::string& key) {
+    size_t pos = line.find("\"" + key + "\": ");
+    return pos == std::string::npos ? 0 : std::stod(line.substr(pos + key.size() + 4));
+}
+
+// Mean ns/op by benchmark name from a report written by toJson
+std::map<std::string, double> readReport(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open report " + path);
+    std::map<std::string, double> means;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t pos = line.find("\"name\": \"");
+        if (pos == std::string::npos) continue;
+        pos += 9;
+        std::string name = line.substr(pos, line.find('"', pos) - pos);
+        means[name] = numberField(line, "mean");
+    }
+    return means;
+}
+
+// Prints the change of every benchmark in both reports; true if none
+// regressed by more than threshold percent
+bool compare(const std::map<std::string, double>& baseline,
+             const std::map<std::string, double>& current, double threshold) {
+    bool ok = true;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& [name, mean] : current) {
+        auto it = baseline.find(name);
+        if (it == baseline.end() || it->second <= 0) continue;
+        double change = (mean / it->second - 1) * 100;
+        bool regressed = change > threshold;
+        ok = ok && !regressed;
+        std::cout << std::left << std::setw(32) << name << std::right << std::setw(12) << it->second
+                  << " -> " << std::setw(12) << mean << " ns/op  " << std::showpos << change
+                  << std::noshowpos << "%" << (regressed ? "  REGRESSION" : "") << "\n";
+    }
+    return ok;
+}
+
+void printUsage() {
+    std::cout << "Usage: benchmark [--filter s] [--repetitions r] [--json out.json]\n"
+              << "                 [--baseline old.json] [--threshold pct]\n"
+              << "       benchmark --compare old.json new.json [--threshold pct]" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string filter, json_path, baseline_path, compare_old, compare_new;
+    int repetitions = 10;
+    double threshold = 10;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--filter" && i + 1 < argc) filter = argv[++i];
+            else if (arg == "--repetitions" && i + 1 < argc) repetitions = std::max(1, std::stoi(argv[++i]));
+            else if (arg == "--json" && i + 1 < argc) json_path = argv[++i];
+            else if (arg == "--baseline" && i + 1 < argc) baseline_path = argv[++i];
+            else if (arg == "--threshold" && i + 1 < argc) threshold = std::stod(argv[++i]);
+            else if (arg == "--compare" && i + 2 < argc) {
+                compare_old = argv[++i];
+                compare_new = argv[++i];
+            } else {
+                printUsage();
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        printUsage();
+        return 1;
+    }
+
+    try {
+        if (!compare_old.empty()) {
+            return compare(readReport(compare_old), readReport(compare_new), threshold) ? 0 : 1;
+        }
+
+        std::vector<Measurement> results;
+        std::cout << std::fixed << std::setprecision(1);
+        for (const auto& benchmark : makeBenchmarks()) {
+            bool selected = filter.empty() ? !benchmark.slow
+                                           : benchmark.name.find(filter) != std::string::npos;
+            if (!selected) continue;
+            Measurement m = measure(benchmark, repetitions);
+            std::cout << std::left << std::setw(32) << m.name << std::right << std::setw(14) << m.mean_ns
+                      << " ns/op  +- " << m.stddev_ns << "  (min " << m.min_ns << ", "
+                      << m.repetitions << " x " << m.ops << " ops)" << std::endl;
+            results.push_back(m);
+        }
+
+        if (!json_path.empty()) {
+            std::ofstream out(json_path);
+            out << toJson(results);
+            std::cout << "Wrote " << json_path << std::endl;
+        }
+        if (!baseline_path.empty()) {
+            std::map<std::string, double> current;
+            for (const auto& m : results) current[m.name] = m.mean_ns;
+            return compare(readReport(baseline_path), current, threshold) ? 0 : 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <iostream>
+#include <string>
+#include "../src/compute_driver.h"
+#include "../src/profiler.h"
+#include "../src/utils.h"
+
+void printUsage() {
+    std::cout << "Usage: compute <n> [options]\n";
+    std::cout << "  --threads <t>                      Synthesis threads (default: all cores)\n";
+    std::cout << "  --backend <pareto|exact|decompose> Synthesis per class (default: pareto)\n";
+    std::cout << "  --format <text|binary>             Output records (default: text)\n";
+    std::cout << "  --output <path>                    Output file (default: data/npn_<n>var.txt)\n";
+    std::cout << "  --max-classes <k>                  Stop after k classes\n";
+    std::cout << "  --sync                             fsync after every class\n";
+    std::cout << "  --resume                           Continue from the last checkpoint\n";
+    std::cout << "  --partition <i/N>                  Only slice i (0 <= i < N) of the functions; the\n";
+    std::cout << "                                     output gets a .part<i>of<N> suffix (see merge_db)\n";
+    std::cout << "  --bound-db <path>                  Seed exact synthesis with upper bounds from this\n";
+    std::cout << "                                     (n-1)-input database\n";
+    std::cout << "  --progress <ms>                    Progress report interval (default: 5000, 0 = off)\n";
+    std::cout << "  --status <path>                    Keep a JSON progress snapshot in path\n";
+    std::cout << "  --profile <path>                   Write a profile (.json, else folded stacks)\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    ComputeOptions options;
+    std::string profile_path;
+    try {
+        options.n_vars = std::stoi(argv[1]);
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "--threads" && has_value) {
+                options.threads = std::stoi(argv[++i]);
+            } else if (arg == "--backend" && has_value) {
+                if (!ComputeDriver::parseBackend(argv[++i], options.backend)) {
+                    printUsage();
+                    return 1;
+                }
+            } else if (arg == "--format" && has_value) {
+                std::string format = argv[++i];
+                if (format != "text" && format != "binary") {
+                    printUsage();
+                    return 1;
+                }
+                options.format = format == "text" ? RecordWriter::Format::Text : RecordWriter::Format::Binary;
+            } else if (arg == "--output" && has_value) {
+                options.output = argv[++i];
+            } else if (arg == "--max-classes" && has_value) {
+                options.max_classes = std::stoul(argv[++i]);
+            } else if (arg == "--sync") {
+                options.sync_every = 1;
+            } else if (arg == "--resume") {
+                options.resume = true;
+            } else if (arg == "--partition" && has_value) {
+                if (!ComputeDriver::parsePartition(argv[++i], options.partition, options.partitions)) {
+                    printUsage();
+                    return 1;
+                }
+            } else if (arg == "--bound-db" && has_value) {
+                options.bound_database = argv[++i];
+            } else if (arg == "--progress" && has_value) {
+                options.progress_interval_ms = std::stoi(argv[++i]);
+            } else if (arg == "--status" && has_value) {
+                options.status_file = argv[++i];
+            } else if (arg == "--profile" && has_value) {
+                profile_path = argv[++i];
+            } else {
+                printUsage();
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        printUsage();
+        return 1;
+    }
+
+    std::string slice;
+    if (options.partitions > 1) {
+        slice = ", partition " + std::to_string(options.partition) + "/" + std::to_string(options.partitions);
+    }
+    Utils::logMessage("Computing NPN classes for n=" + std::to_string(options.n_vars) + slice);
+    ComputeStats stats;
+    try {
+        stats = ComputeDriver::run(options);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n";
+        printUsage();
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    std::cout << "\n" << std::string(50, '=') << std::endl;
+    std::cout << "SYNTHESIS COMPLETE" << std::endl;
+    std::cout << std::string(50, '=') << std::endl;
+    std::cout << "Functions enumerated: " << stats.functions << std::endl;
+    std::cout << "Classes: " << stats.classes << std::endl;
+    std::cout << "Synthesized this run: " << stats.synthesized << std::endl;
+    std::cout << "Failed: " << stats.failed << std::endl;
+    std::cout << "Wall time: " << stats.seconds << " seconds" << std::endl;
+
+    std::cout << "\nSize distribution:" << std::endl;
+    for (const auto& [size, count] : stats.size_distribution) {
+        std::cout << "  " << size << " gates: " << count << " classes" << std::endl;
+    }
+
+    Utils::logMessage("Completed n=" + std::to_string(options.n_vars) + ": " +
+                      std::to_string(stats.classes) + " classes in " +
+                      std::to_string(stats.seconds) + "s");
+    if (!profile_path.empty()) {
+        Profiler::dump(profile_path);
+        std::cout << "Profile written to " << profile_path << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include <iostream>
+#include <string>
+#include "../src/npn_database.h"
+#include "../src/utils.h"
+
+// Converts a text class database or a binary record stream into the indexed
+// binary format
+int main(int argc, char* argv[]) {
+    // -z writes the block-compressed layout (meant for n=5)
+    bool compress = argc > 1 && std::string(argv[1]) == "-z";
+    if (compress) {
+        argv++;
+        argc--;
+    }
+
+    std::string input, output;
+    if (argc == 2) {
+        std::string n_vars = argv[1];
+        input = "data/npn_" + n_vars + "var.txt";
+        output = "data/npn_" + n_vars + "var.db";
+    } else if (argc == 3) {
+        input = argv[1];
+        output = argv[2];
+    } else {
+        std::cout << "Usage: convert_db [-z] <n> | convert_db [-z] <input.txt> <output.db>" << std::endl;
+        return 1;
+    }
+
+    Utils::Timer timer("convert_db");
+    std::string contents = Utils::loadFromTxt(input);
+    auto classes = NPNDatabase::isRecordStream(contents) ? NPNDatabase::parseRecords(contents)
+                                                         : NPNDatabase::parseText(contents);
+    if (compress) {
+        NPNDatabase::writeCompressed(classes, output);
+    } else {
+        NPNDatabase::writeBinary(classes, output);
+    }
+
+    NPNDatabase db(output);
+    Utils::logMessage("Converted " + std::to_string(db.size()) + " classes from " + input +
+                      " to " + output);
+    return 0;
+}
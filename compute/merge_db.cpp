@@ -0,0 +1,52 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../src/compute_driver.h"
+#include "../src/npn_database.h"
+#include "../src/record_writer.h"
+#include "../src/truth_table.h"
+#include "../src/utils.h"
+
+// Merges the partial outputs of `compute <n> --partition i/N` runs into one
+// database: an indexed .db (-z for the block-compressed layout), or text
+// records for any other extension
+int main(int argc, char* argv[]) {
+    bool compress = argc > 1 && std::string(argv[1]) == "-z";
+    if (compress) {
+        argv++;
+        argc--;
+    }
+    if (argc < 3) {
+        std::cout << "Usage: merge_db [-z] <output.db|output.txt> <part>..." << std::endl;
+        return 1;
+    }
+
+    std::string output = argv[1];
+    std::vector<std::string> parts(argv + 2, argv + argc);
+    Utils::Timer timer("merge_db");
+    std::vector<DatabaseClass> classes;
+    try {
+        classes = ComputeDriver::mergePartitions(parts);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    if (classes.empty()) {
+        std::cerr << "No classes in the partial outputs" << std::endl;
+        return 1;
+    }
+
+    bool indexed = output.size() > 3 && output.compare(output.size() - 3, 3, ".db") == 0;
+    if (indexed && compress) {
+        NPNDatabase::writeCompressed(classes, output);
+    } else if (indexed) {
+        NPNDatabase::writeBinary(classes, output);
+    } else {
+        RecordWriter writer(output, TruthTable::getNumVars(classes.front().representative));
+        for (const auto& cls : classes) writer.write(cls);
+        writer.close();
+    }
+    Utils::logMessage("Merged " + std::to_string(classes.size()) + " classes from " +
+                      std::to_string(parts.size()) + " partitions into " + output);
+    return 0;
+}
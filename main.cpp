@@ -3,17 +3,27 @@
 #include <vector>
 #include <set>
 #include <string>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
 #include "truth_table.h"
 #include "npn_classifier.h"
 #include "mig_synthesizer.h"
 #include "mig_structure.h"
+#include "decomposition.h"
+#include "npn_database.h"
+#include "synthesis_cache.h"
+#include "query_server.h"
+#include "compute_driver.h"
 #include "utils.h"
 
 // Print usage information
 void printUsage() {
     std::cout << "Options:\n";
     std::cout << "  --function <truth_table> <nvars>  Query a specific function\n";
-    std::cout << "  --compute <n>                     Compute all NPN classes\n";
+    std::cout << "  --compute <n> [--resume]          Compute all NPN classes\n";
+    std::cout << "  --serve [socket_path]             Answer queries from stdin (and a Unix socket)\n";
+    std::cout << "  --batch [file]                    Classify every truth table in a file (or stdin)\n";
     std::cout << "  --test                            Run tests\n";
     std::cout << "  --help                            Show this help message\n";
 }
@@ -22,15 +32,16 @@ void printUsage() {
 void queryMIG(const std::string& truth_table, int n_vars) {
     std::string representative = NPNClassifier::getNPNRepresentative(truth_table);
 
-    std::string filename = "data/npn_" + std::to_string(n_vars) + "var.txt";
+    std::string filename = "data/npn_" + std::to_string(n_vars) + "var.db";
     try {
-        std::string db = Utils::loadFromTxt(filename);
-        size_t pos = db.find("CLASS " + representative);
-        if (pos != std::string::npos) {
-            size_t end = db.find("---", pos);
-            std::string result = db.substr(pos, end - pos);
+        NPNDatabase db(filename);
+        DatabaseClass cls;
+        if (db.find(representative, cls)) {
             std::ofstream fout("output.txt");
-            fout << "Found in database:\n" << result << "\n";
+            fout << "Found in database:\nCLASS " << representative << "\n";
+            for (const auto& mig : cls.points) {
+                fout << "POINT " << mig.size() << " " << mig.depth() << "\n" << mig.toText();
+            }
             fout.close();
             std::cout << "Saved database result to output.txt\n";
             return;
@@ -40,7 +51,16 @@ void queryMIG(const std::string& truth_table, int n_vars) {
     }
 
     std::cout << "Not found in database. Synthesizing...\n";
-    auto mig = synthesizeOptimalMIG(truth_table);
+    SynthesisCache cache("data/synthesis_cache.log");
+    std::unique_ptr<MIG> mig;
+    if (n_vars > 4) {
+        // Split wide functions into blocks that are each cheap to synthesize
+        mig = Decomposer::synthesize(representative, [&cache](const std::string& block) {
+            return cache.getOrSynthesize(block);
+        });
+    } else {
+        mig = cache.getOrSynthesize(representative);
+    }
     if (mig) {
         std::ofstream fout("output.txt");
         fout << "Synthesized MIG:\n";
@@ -52,53 +72,30 @@ void queryMIG(const std::string& truth_table, int n_vars) {
     }
 }
 
-// Optimized computeNPN function
-void computeNPN(int n_vars) {
+// Computes every NPN class with the pipelined driver and writes both the text
+// and the indexed database. With resume set, a run picks up where the
+// checkpoint in data/npn_<n>var.checkpoint left off.
+void computeNPN(int n_vars, bool resume) {
     std::cout << "Computing NPN classes for n=" << n_vars << "...\n";
 
-    int num_rows = 1 << n_vars;
-    int num_functions = 1 << num_rows;  // 2^(2^n)
-    std::set<std::string> npn_classes;
-
-    for (int func = 0; func < num_functions; ++func) {
-        // Generate truth table string
-        std::string tt(num_rows, '0');
-        for (int row = 0; row < num_rows; ++row) {
-            tt[row] = ((func >> row) & 1) ? '1' : '0';
-        }
-
-        // Compute NPN representative
-        std::string rep = NPNClassifier::getNPNRepresentative(tt);
-        npn_classes.insert(rep);
-
-        // Optional: progress indicator every 1000 functions
-        if (func % 1000 == 0) {
-            std::cout << "\rProcessed " << func << "/" << num_functions << " functions..." << std::flush;
-        }
-    }
-
-    std::cout << "\nFound " << npn_classes.size() << " unique NPN classes.\n";
-
-    // Save NPN classes to file
-    std::string out_file = "data/npn_" + std::to_string(n_vars) + "var.txt";
-    std::ofstream fout(out_file);
-
-    int class_index = 1;
-    for (const auto& cls_tt : npn_classes) {
-        fout << "CLASS " << class_index << ": " << cls_tt << "\n";
-
-        // Synthesize MIG for each class
-        auto mig = synthesizeOptimalMIG(cls_tt);
-        if (mig) {
-            fout << "  Size: " << mig->size() << ", Depth: " << mig->depth() << "\n";
-        }
-        fout << "---\n";
-
-        class_index++;
+    ComputeOptions options;
+    options.n_vars = n_vars;
+    options.resume = resume;
+    ComputeStats stats;
+    try {
+        stats = ComputeDriver::run(options);
+    } catch (const std::exception& e) {
+        std::cout << e.what() << "\n";
+        return;
     }
+    std::cout << "Found " << stats.classes << " unique NPN classes.\n";
 
-    fout.close();
+    std::string out_file = ComputeDriver::defaultOutput(n_vars, options.format);
     std::cout << "Saved NPN classes to " << out_file << "\n";
+
+    std::string db_file = "data/npn_" + std::to_string(n_vars) + "var.db";
+    NPNDatabase::writeBinary(NPNDatabase::parseText(Utils::loadFromTxt(out_file)), db_file);
+    std::cout << "Saved indexed database to " << db_file << "\n";
 }
 
 int main(int argc, char* argv[]) {
@@ -123,14 +120,51 @@ int main(int argc, char* argv[]) {
 
     if (command == "--compute" && argc >= 3) {
         int n_vars = std::stoi(argv[2]);
-        computeNPN(n_vars);
+        bool resume = argc >= 4 && std::string(argv[3]) == "--resume";
+        computeNPN(n_vars, resume);
         return 0;
     }
 
+    if (command == "--serve") {
+        QueryServer server;
+        std::thread socket_thread;
+        if (argc >= 3) {
+            std::string socket_path = argv[2];
+            socket_thread = std::thread([&server, socket_path]() {
+                try {
+                    server.serveSocket(socket_path);
+                } catch (const std::exception& e) {
+                    std::cerr << e.what() << "\n";
+                }
+            });
+        }
+        server.serveStream(0, 1);
+        // Keep the socket open until it is shut down externally
+        if (socket_thread.joinable()) socket_thread.join();
+        return 0;
+    }
+
+    if (command == "--batch") {
+        int in_fd = 0;
+        if (argc >= 3 && std::string(argv[2]) != "-") {
+            in_fd = open(argv[2], O_RDONLY);
+            if (in_fd < 0) {
+                std::cerr << "Cannot open " << argv[2] << "\n";
+                return 1;
+            }
+        }
+        QueryServer server;
+        bool ok = server.serveBatch(in_fd, 1);
+        if (in_fd != 0) close(in_fd);
+        return ok ? 0 : 1;
+    }
+
     if (command == "--test") {
         system("./test_maj3");
         system("./test_npn");
         system("./test_synthesis");
+        system("./test_database");
+        system("./test_logging");
         return 0;
     }
 
@@ -0,0 +1,84 @@
+#include "checkpoint.h"
+#include "truth_table.h"
+#include "utils.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#define fsync _commit
+#define fileno _fileno
+#else
+#include <unistd.h>
+#endif
+
+Checkpoint::Checkpoint(const std::string& path, int interval_ms)
+    : path(path), interval(interval_ms), last_save(std::chrono::steady_clock::now()) {}
+
+bool Checkpoint::load() {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    std::string keyword;
+    int version = 0;
+    size_t num_classes = 0;
+    if (!(file >> keyword >> version) || keyword != "CHECKPOINT" || version != 1) return false;
+    if (!(file >> keyword >> n_vars) || keyword != "n_vars") return false;
+    if (!(file >> keyword >> cursor) || keyword != "cursor") return false;
+    if (!(file >> keyword >> completed) || keyword != "completed") return false;
+    if (!(file >> keyword >> output_bytes) || keyword != "output_bytes") return false;
+    if (!(file >> keyword >> num_classes) || keyword != "classes") return false;
+
+    classes.clear();
+    classes.reserve(num_classes);
+    std::string rep;
+    while (classes.size() < num_classes && file >> rep) {
+        if (!TruthTable::validateTruthTable(rep)) return false;
+        classes.push_back(rep);
+    }
+    return classes.size() == num_classes && completed <= num_classes;
+}
+
+bool Checkpoint::due() const {
+    return std::chrono::steady_clock::now() - last_save >= interval;
+}
+
+void Checkpoint::save() {
+    std::ostringstream out;
+    out << "CHECKPOINT 1\n"
+        << "n_vars " << n_vars << "\n"
+        << "cursor " << cursor << "\n"
+        << "completed " << completed << "\n"
+        << "output_bytes " << output_bytes << "\n"
+        << "classes " << classes.size() << "\n";
+    for (const auto& rep : classes) out << rep << "\n";
+    std::string contents = out.str();
+
+    size_t last_slash = path.find_last_of("/\\");
+    if (last_slash != std::string::npos) {
+        Utils::ensureDir(path.substr(0, last_slash));
+    }
+    std::string tmp_path = path + ".tmp";
+    std::FILE* file = std::fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        throw std::runtime_error("Cannot write checkpoint: " + tmp_path);
+    }
+    bool ok = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size() &&
+              std::fflush(file) == 0 && fsync(fileno(file)) == 0;
+    ok = (std::fclose(file) == 0) && ok;
+#ifdef _WIN32
+    // rename() does not replace an existing file on Windows
+    std::remove(path.c_str());
+#endif
+    if (!ok || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        throw std::runtime_error("Cannot write checkpoint: " + path);
+    }
+    last_save = std::chrono::steady_clock::now();
+}
+
+void Checkpoint::remove() {
+    std::remove(path.c_str());
+}
@@ -0,0 +1,48 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Progress of an enumeration + synthesis job, saved atomically (written to a
+// temporary file, synced, then renamed over the old checkpoint):
+//   CHECKPOINT 1
+//   n_vars <n>
+//   cursor <next function to enumerate>
+//   completed <classes already synthesized>
+//   output_bytes <length of the output file covering them>
+//   classes <count>
+//   <representative>...
+// Saves are rate limited by interval_ms, so their cost stays a small fraction
+// of the job however often save() is offered.
+class Checkpoint {
+public:
+    int n_vars = 0;
+    uint64_t cursor = 0;
+    std::vector<std::string> classes;
+    size_t completed = 0;
+    uint64_t output_bytes = 0;
+
+    explicit Checkpoint(const std::string& path, int interval_ms = 30000);
+
+    // Reads the checkpoint file; false if there is none or it is unreadable
+    bool load();
+
+    // True once interval_ms has passed since the last save
+    bool due() const;
+    void save();
+
+    // Deletes the checkpoint once the job has finished
+    void remove();
+
+    const std::string& getPath() const { return path; }
+
+private:
+    std::string path;
+    std::chrono::milliseconds interval;
+    std::chrono::steady_clock::time_point last_save;
+};
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,398 @@
+#include "compute_driver.h"
+#include "bounded_queue.h"
+#include "checkpoint.h"
+#include "npn_database.h"
+#include "decomposition.h"
+#include "mig_synthesizer.h"
+#include "npn_classifier.h"
+#include "profiler.h"
+#include "progress_reporter.h"
+#include "truth_table.h"
+#include "utils.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+struct Job {
+    size_t index;
+    std::string representative;
+};
+
+struct Result {
+    size_t index;
+    DatabaseClass cls;
+    double seconds;
+};
+
+DatabaseClass synthesizeClass(const std::string& rep, ComputeOptions::Backend backend,
+                              const NPNDatabase* bound_database) {
+    DatabaseClass cls{rep, {}};
+    if (backend == ComputeOptions::Backend::Exact && bound_database) {
+        auto bound = Decomposer::shannonUpperBound(rep, [bound_database](const std::string& cofactor) {
+            auto mig = std::make_unique<MIG>();
+            return bound_database->findFunction(cofactor, *mig) ? std::move(mig) : std::unique_ptr<MIG>();
+        });
+        if (bound) {
+            MIGSynthesizer synthesizer;
+            auto mig = synthesizer.synthesizeSizeOptimal(rep, *bound);
+            if (!synthesizer.getStats().timed_out) cls.points.push_back(*mig);
+            return cls;
+        }
+    }
+    if (backend == ComputeOptions::Backend::Pareto) {
+        for (const auto& mig : synthesizeParetoMIGs(rep)) cls.points.push_back(*mig);
+        return cls;
+    }
+    auto mig = backend == ComputeOptions::Backend::Exact ? synthesizeOptimalMIG(rep)
+                                                         : Decomposer::synthesize(rep);
+    if (mig) cls.points.push_back(*mig);
+    return cls;
+}
+
+// Smaller first point, then shallower, then the smaller encoding
+bool preferred(const DatabaseClass& a, const DatabaseClass& b) {
+    const MIG& x = a.points.front();
+    const MIG& y = b.points.front();
+    if (x.size() != y.size()) return x.size() < y.size();
+    if (x.depth() != y.depth()) return x.depth() < y.depth();
+    return x.toCompact() < y.toCompact();
+}
+
+} // namespace
+
+std::string ComputeDriver::defaultOutput(int n_vars, RecordWriter::Format format) {
+    return "data/npn_" + std::to_string(n_vars) + "var" +
+           (format == RecordWriter::Format::Text ? ".txt" : ".bin");
+}
+
+std::string ComputeDriver::checkpointPath(const std::string& output) {
+    size_t dot = output.find_last_of('.');
+    size_t slash = output.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return output + ".checkpoint";
+    }
+    return output.substr(0, dot) + ".checkpoint";
+}
+
+std::string ComputeDriver::partitionOutput(const std::string& output, int partition, int partitions) {
+    std::string suffix = ".part" + std::to_string(partition) + "of" + std::to_string(partitions);
+    size_t dot = output.find_last_of('.');
+    size_t slash = output.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return output + suffix;
+    }
+    return output.substr(0, dot) + suffix + output.substr(dot);
+}
+
+bool ComputeDriver::parsePartitionOutput(const std::string& output, int& partition, int& partitions) {
+    size_t slash = output.find_last_of("/\\");
+    size_t at = output.rfind(".part");
+    if (at == std::string::npos || (slash != std::string::npos && at < slash)) return false;
+    size_t of = output.find("of", at + 5);
+    if (of == std::string::npos) return false;
+    size_t end = output.find('.', of);
+    std::string count = end == std::string::npos ? output.substr(of + 2) : output.substr(of + 2, end - of - 2);
+    return parsePartition(output.substr(at + 5, of - at - 5) + "/" + count, partition, partitions);
+}
+
+bool ComputeDriver::parsePartition(const std::string& spec, int& partition, int& partitions) {
+    size_t slash = spec.find('/');
+    if (slash == std::string::npos || slash == 0 || slash + 1 == spec.size()) return false;
+    if (spec.find_first_not_of("0123456789/") != std::string::npos || spec.find('/', slash + 1) != std::string::npos) {
+        return false;
+    }
+    try {
+        partition = std::stoi(spec.substr(0, slash));
+        partitions = std::stoi(spec.substr(slash + 1));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return partitions >= 1 && partition < partitions;
+}
+
+std::vector<DatabaseClass> ComputeDriver::mergePartitions(const std::vector<std::string>& paths) {
+    std::map<uint64_t, DatabaseClass> merged;
+    int n_vars = -1;
+    int num_slices = 0;
+    std::set<int> slices;
+    for (const auto& path : paths) {
+        if (Checkpoint(checkpointPath(path)).load()) {
+            throw std::runtime_error("Partition " + path + " is unfinished (checkpoint present)");
+        }
+        int partition = 0, partitions = 1;
+        if (!parsePartitionOutput(path, partition, partitions)) {
+            partition = 0;
+            partitions = 1;
+        }
+        if (num_slices > 0 && partitions != num_slices) {
+            throw std::runtime_error("Partitions mix " + std::to_string(num_slices) + " and " +
+                                     std::to_string(partitions) + " slices");
+        }
+        num_slices = partitions;
+        slices.insert(partition);
+        std::string contents = Utils::loadFromTxt(path);
+        auto classes = NPNDatabase::isRecordStream(contents) ? NPNDatabase::parseRecords(contents)
+                                                             : NPNDatabase::parseText(contents);
+        for (auto& cls : classes) {
+            int vars = TruthTable::getNumVars(cls.representative);
+            if (n_vars >= 0 && vars != n_vars) {
+                throw std::runtime_error("Partitions mix " + std::to_string(n_vars) + " and " +
+                                         std::to_string(vars) + " inputs");
+            }
+            n_vars = vars;
+            if (cls.points.empty()) continue;
+            uint64_t key = TruthTable::truthTableToBinary(cls.representative);
+            auto it = merged.find(key);
+            if (it == merged.end()) {
+                merged.emplace(key, std::move(cls));
+            } else if (preferred(cls, it->second)) {
+                it->second = std::move(cls);
+            }
+        }
+    }
+    if (static_cast<int>(slices.size()) != num_slices) {
+        std::string missing;
+        for (int i = 0; i < num_slices; ++i) {
+            if (!slices.count(i)) missing += (missing.empty() ? "" : ", ") + std::to_string(i);
+        }
+        throw std::runtime_error("Missing partitions " + missing + " of " + std::to_string(num_slices));
+    }
+    std::vector<DatabaseClass> classes;
+    classes.reserve(merged.size());
+    for (auto& entry : merged) classes.push_back(std::move(entry.second));
+    return classes;
+}
+
+bool ComputeDriver::parseBackend(const std::string& name, ComputeOptions::Backend& backend) {
+    if (name == "pareto") backend = ComputeOptions::Backend::Pareto;
+    else if (name == "exact") backend = ComputeOptions::Backend::Exact;
+    else if (name == "decompose") backend = ComputeOptions::Backend::Decompose;
+    else return false;
+    return true;
+}
+
+ComputeStats ComputeDriver::run(const ComputeOptions& options) {
+    int n_vars = options.n_vars;
+    if (n_vars < 1 || n_vars > 5) {
+        throw std::invalid_argument("Compute supports 1 to 5 variables");
+    }
+    if (options.partitions < 1 || options.partition < 0 || options.partition >= options.partitions) {
+        throw std::invalid_argument("Partition must satisfy 0 <= i < N");
+    }
+    std::unique_ptr<NPNDatabase> bound_database;
+    if (!options.bound_database.empty()) {
+        try {
+            bound_database = std::make_unique<NPNDatabase>(options.bound_database);
+        } catch (const std::runtime_error& e) {
+            throw std::invalid_argument(std::string("Bad bound database: ") + e.what());
+        }
+        if (bound_database->numVars() != n_vars - 1) {
+            throw std::invalid_argument("Bound database must hold " + std::to_string(n_vars - 1) +
+                                        "-input classes");
+        }
+    }
+    auto start_time = std::chrono::steady_clock::now();
+    // This run enumerates [first, last) and owns the classes whose packed
+    // representative lies in it
+    TruthTableRange slice = TruthTableRange(n_vars).split(options.partitions)[options.partition];
+    uint64_t last_function = slice.last();
+    std::string output = options.output.empty() ? defaultOutput(n_vars, options.format) : options.output;
+    int named_partition = 0, named_partitions = 1;
+    if (options.partitions > 1 &&
+        (!parsePartitionOutput(output, named_partition, named_partitions) ||
+         named_partition != options.partition || named_partitions != options.partitions)) {
+        output = partitionOutput(output, options.partition, options.partitions);
+    }
+
+    Checkpoint checkpoint(checkpointPath(output), options.checkpoint_interval_ms);
+    if (options.resume && checkpoint.load() && checkpoint.n_vars == n_vars &&
+        checkpoint.cursor >= slice.first() && checkpoint.cursor <= slice.last()) {
+        Utils::logMessage("Resuming at function " + std::to_string(checkpoint.cursor) + ", " +
+                          std::to_string(checkpoint.completed) + " classes written");
+    } else {
+        checkpoint = Checkpoint(checkpoint.getPath(), options.checkpoint_interval_ms);
+        checkpoint.n_vars = n_vars;
+        checkpoint.cursor = slice.first();
+    }
+
+    // Enumerator state shared with the checkpoint; every owned class of a
+    // function below cursor is in discovered
+    std::mutex state_mutex;
+    std::vector<std::string> discovered = checkpoint.classes;
+    uint64_t cursor = checkpoint.cursor;
+    uint64_t first_function = checkpoint.cursor;
+    size_t first_index = checkpoint.completed;
+
+    RecordWriter writer(output, n_vars, options.format, options.sync_every, 1 << 20,
+                        first_index > 0 ? static_cast<int64_t>(checkpoint.output_bytes) : -1);
+    BoundedQueue<Job> jobs(options.queue_capacity);
+    BoundedQueue<Result> results(options.queue_capacity);
+    ComputeStats stats;
+
+    ProgressCounters counters;
+    counters.classes = discovered.size();
+    counters.synthesized = first_index;
+    ProgressReporter progress(counters, last_function - first_function, options.progress_interval_ms,
+                              options.status_file, [&jobs]() { return jobs.size(); });
+    progress.start();
+
+    std::thread enumerator([&]() {
+        MIG_PROFILE_SCOPE("compute.enumerate");
+        std::unordered_set<uint64_t> seen;
+        for (const auto& rep : discovered) seen.insert(TruthTable::truthTableToBinary(rep));
+        for (size_t i = first_index; i < discovered.size(); ++i) {
+            if (!jobs.push({i, discovered[i]})) return;
+        }
+
+        TruthTableRange range(n_vars, cursor, last_function);
+        std::vector<uint64_t> chunk, reps;
+        uint64_t func = cursor;
+        bool stop = options.max_classes > 0 && discovered.size() >= options.max_classes;
+        while (!stop && range.nextChunk(chunk)) {
+            reps.resize(chunk.size());
+            NPNClassifier::canonizeBatch(chunk.data(), reps.data(), chunk.size(), n_vars);
+            for (size_t i = 0; i < chunk.size(); ++i) {
+                func = chunk[i] + 1;
+                if (reps[i] < slice.first() || reps[i] >= slice.last()) continue;
+                if (!seen.insert(reps[i]).second) continue;
+                std::string rep = TruthTable::binaryToTruthTable(reps[i], n_vars);
+
+                size_t index;
+                {
+                    std::lock_guard<std::mutex> lock(state_mutex);
+                    index = discovered.size();
+                    discovered.push_back(rep);
+                    stop = options.max_classes > 0 && discovered.size() >= options.max_classes;
+                }
+                if (!jobs.push({index, rep})) stop = true;
+                if (stop) break;
+            }
+            std::lock_guard<std::mutex> lock(state_mutex);
+            cursor = func;
+            counters.functions.store(func - first_function, std::memory_order_relaxed);
+            counters.classes.store(discovered.size(), std::memory_order_relaxed);
+        }
+        stats.functions = func - first_function;
+        counters.enumerated.store(true, std::memory_order_relaxed);
+        jobs.close();
+    });
+
+    int num_threads = options.threads > 0 ? options.threads
+                                          : std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<int> running{num_threads};
+
+    // Reorder window: a worker only starts a class once every class more
+    // than window places before it has been written, so the writer never
+    // holds more than window results back for ordering
+    const size_t window = options.queue_capacity + num_threads;
+    std::mutex window_mutex;
+    std::condition_variable window_advanced;
+    size_t written = first_index;
+    bool aborted = false;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < num_threads; ++t) {
+        workers.emplace_back([&]() {
+            Job job;
+            while (jobs.pop(job)) {
+                {
+                    std::unique_lock<std::mutex> lock(window_mutex);
+                    window_advanced.wait(lock, [&]() { return aborted || job.index < written + window; });
+                    if (aborted) break;
+                }
+                MIG_PROFILE_SCOPE("compute.synthesize");
+                auto start = std::chrono::steady_clock::now();
+                DatabaseClass cls = synthesizeClass(job.representative, options.backend, bound_database.get());
+                double seconds =
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (!results.push({job.index, std::move(cls), seconds})) break;
+            }
+            if (--running == 0) results.close();
+        });
+    }
+
+    // Writer stage: puts results back in discovery order
+    std::unordered_map<size_t, Result> pending;
+    size_t next_index = first_index;
+    try {
+        Result result;
+        while (results.pop(result)) {
+            pending.emplace(result.index, std::move(result));
+            stats.max_pending = std::max(stats.max_pending, pending.size());
+            size_t first_pending = next_index;
+            for (auto it = pending.find(next_index); it != pending.end(); it = pending.find(next_index)) {
+                const DatabaseClass& cls = it->second.cls;
+                if (cls.points.empty()) {
+                    stats.failed++;
+                    Utils::logMessage("Failed to synthesize " + cls.representative, "logs/synthesis.log",
+                                      LogLevel::Warning);
+                } else {
+                    MIG_PROFILE_SCOPE("compute.write");
+                    writer.write(cls, it->second.seconds);
+                    stats.synthesized++;
+                    stats.size_distribution[cls.points.front().size()]++;
+                }
+                pending.erase(it);
+                next_index++;
+                counters.synthesized.store(next_index, std::memory_order_relaxed);
+            }
+            if (next_index != first_pending) {
+                std::lock_guard<std::mutex> lock(window_mutex);
+                written = next_index;
+                window_advanced.notify_all();
+            }
+
+            if (checkpoint.due()) {
+                writer.flush(true);
+                std::lock_guard<std::mutex> lock(state_mutex);
+                checkpoint.cursor = cursor;
+                checkpoint.classes = discovered;
+                checkpoint.completed = next_index;
+                checkpoint.output_bytes = writer.offset();
+                checkpoint.save();
+            }
+        }
+    } catch (...) {
+        // Unblock the other stages so their threads can be joined
+        jobs.close();
+        results.close();
+        {
+            std::lock_guard<std::mutex> lock(window_mutex);
+            aborted = true;
+            window_advanced.notify_all();
+        }
+        enumerator.join();
+        for (auto& worker : workers) worker.join();
+        throw;
+    }
+
+    enumerator.join();
+    for (auto& worker : workers) worker.join();
+    writer.close();
+    progress.stop();
+
+    stats.classes = discovered.size();
+    if (cursor < last_function) {
+        // Stopped at max_classes: keep the position for --resume
+        checkpoint.cursor = cursor;
+        checkpoint.classes = discovered;
+        checkpoint.completed = next_index;
+        checkpoint.output_bytes = writer.offset();
+        checkpoint.save();
+    } else {
+        checkpoint.remove();
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    return stats;
+}
@@ -0,0 +1,93 @@
+#ifndef COMPUTE_DRIVER_H
+#define COMPUTE_DRIVER_H
+
+#include "record_writer.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+struct ComputeOptions {
+    enum class Backend { Pareto, Exact, Decompose };
+
+    int n_vars = 4;
+    int threads = 0;                // synthesis workers, 0 = one per hardware thread
+    Backend backend = Backend::Pareto;
+    RecordWriter::Format format = RecordWriter::Format::Text;
+    std::string output;             // empty = data/npn_<n>var.txt (.bin for binary)
+    size_t max_classes = 0;         // stop after this many classes, 0 = all
+    bool resume = false;
+    int checkpoint_interval_ms = 30000;
+    int sync_every = 0;             // see RecordWriter
+    size_t queue_capacity = 256;    // also bounds the results held back for ordering, see run()
+    int progress_interval_ms = 5000;    // 0 = no progress reports
+    std::string status_file;            // JSON progress snapshot, empty = none
+    int partition = 0;              // slice partition of partitions, see run()
+    int partitions = 1;
+    std::string bound_database;     // (n-1)-input database seeding the exact backend, empty = none
+};
+
+struct ComputeStats {
+    uint64_t functions = 0;         // enumerated by this run
+    size_t classes = 0;             // known at the end, including resumed ones
+    size_t synthesized = 0;         // written by this run
+    size_t failed = 0;
+    size_t max_pending = 0;         // most results held back by the writer to keep discovery order
+    double seconds = 0;
+    std::map<int, int> size_distribution;
+};
+
+// Enumerates every n-input function, classifies it and synthesizes each new
+// class, as three stages joined by bounded queues:
+//
+//   enumerate + classify (1 thread) -> synthesize (threads) -> write (caller)
+//
+// Synthesis starts on the first class while enumeration is still running, so
+// the run takes about as long as its slowest stage. Records are written in
+// discovery order; since workers take classes in that order, the writer only
+// holds back results still waiting on a slower earlier class, and workers
+// wait rather than run more than queue_capacity + threads classes ahead of
+// the last one written, which bounds that backlog. Progress is
+// checkpointed next to the output for resume, and reported (rate, queue
+// depth, ETA) by a ProgressReporter sampling counters the stages publish.
+//
+// With partitions > 1 the run enumerates only slice `partition` of the
+// function space (TruthTableRange::split) and keeps the classes whose packed
+// representative lies in that slice. Every representative is a function of
+// its own slice, so the slices own disjoint sets of classes that together
+// cover all of them: independent processes, each with its own output and
+// checkpoint, synthesize every class exactly once, and mergePartitions
+// combines their files. The output name always carries the slice
+// (partitionOutput), which is how the merge knows it has all of them.
+//
+// With a bound database the exact backend starts every search from
+// Decomposer::shannonUpperBound over the cofactor classes stored there;
+// classes whose bound is not proven optimal in time still count as failed.
+class ComputeDriver {
+public:
+    // Throws std::invalid_argument for bad options, including a bound
+    // database that cannot be opened or has the wrong input count
+    static ComputeStats run(const ComputeOptions& options);
+
+    // Classes of the partial outputs (text or binary records), deduplicated
+    // and sorted by packed representative. A duplicate keeps the point list
+    // whose first point has the fewest gates, then the lowest depth, so the
+    // result does not depend on the order of paths. A path without a slice
+    // in its name is a whole run (slice 0/1). Throws std::runtime_error if a
+    // part still has a checkpoint (unfinished slice), the slices are not
+    // exactly 0 .. N-1 of one N, or the parts mix input counts.
+    static std::vector<DatabaseClass> mergePartitions(const std::vector<std::string>& paths);
+
+    static std::string defaultOutput(int n_vars, RecordWriter::Format format);
+    // data/npn_5var.txt -> data/npn_5var.part2of8.txt
+    static std::string partitionOutput(const std::string& output, int partition, int partitions);
+    // Slice named by the last .part<i>of<N> in the file name; false if none
+    static bool parsePartitionOutput(const std::string& output, int& partition, int& partitions);
+    // "i/N" with 0 <= i < N
+    static bool parsePartition(const std::string& spec, int& partition, int& partitions);
+    static std::string checkpointPath(const std::string& output);
+    static bool parseBackend(const std::string& name, ComputeOptions::Backend& backend);
+};
+
+#endif // COMPUTE_DRIVER_H
@@ -0,0 +1,237 @@
+#include "decomposition.h"
+#include "truth_table.h"
+#include <stdexcept>
+
+namespace {
+
+constexpr int kMaxVars = 6;
+
+uint64_t tableMask(int n_vars) {
+    return (n_vars == kMaxVars) ? ~0ULL : ((1ULL << (1 << n_vars)) - 1);
+}
+
+// tt restricted to vars, assuming it does not depend on any other variable
+uint64_t restrictTo(uint64_t tt, int n_vars, const std::vector<int>& vars) {
+    int m = static_cast<int>(vars.size());
+    uint64_t result = 0;
+    for (int row = 0; row < (1 << m); ++row) {
+        int full_row = 0;
+        for (int j = 0; j < m; ++j) {
+            if ((row >> (m - 1 - j)) & 1) full_row |= 1 << (n_vars - 1 - vars[j]);
+        }
+        if ((tt >> full_row) & 1) result |= 1ULL << row;
+    }
+    return result;
+}
+
+// Checks the bound set given by bound_mask: every cofactor over the free
+// variables must be 0, 1, h or ¬h for a single function h of the bound set.
+bool tryBoundSet(uint64_t tt, int n_vars, int bound_mask, DisjointDecomposition& result) {
+    std::vector<int> bound, free;
+    for (int v = 0; v < n_vars; ++v) {
+        ((bound_mask >> v) & 1 ? bound : free).push_back(v);
+    }
+    const uint64_t mask = tableMask(n_vars);
+    const int num_free = static_cast<int>(free.size());
+
+    // kind per free assignment: 0 = constant 0, 1 = constant 1, 2 = h, 3 = ¬h
+    std::vector<int> kind(1 << num_free);
+    uint64_t h = 0;
+    bool have_h = false;
+    for (int b = 0; b < (1 << num_free); ++b) {
+        uint64_t cof = tt;
+        for (int j = 0; j < num_free; ++j) {
+            cof = TruthTable::getCofactorPacked(cof, n_vars, free[j], (b >> (num_free - 1 - j)) & 1);
+        }
+        if (cof == 0) {
+            kind[b] = 0;
+        } else if (cof == mask) {
+            kind[b] = 1;
+        } else if (!have_h || cof == h) {
+            h = cof;
+            have_h = true;
+            kind[b] = 2;
+        } else if (cof == (~h & mask)) {
+            kind[b] = 3;
+        } else {
+            return false;
+        }
+    }
+    if (!have_h) return false;
+
+    result.bound_vars = bound;
+    result.free_vars = free;
+    result.inner = TruthTable::binaryToTruthTable(restrictTo(h, n_vars, bound),
+                                                  static_cast<int>(bound.size()));
+
+    // Outer function: the inner output is its first (most significant) input
+    uint64_t outer = 0;
+    for (int b = 0; b < (1 << num_free); ++b) {
+        for (int y = 0; y <= 1; ++y) {
+            int value = (kind[b] < 2) ? kind[b] : (y ^ (kind[b] == 3));
+            if (value) outer |= 1ULL << ((y << num_free) | b);
+        }
+    }
+    result.outer = TruthTable::binaryToTruthTable(outer, num_free + 1);
+    return true;
+}
+
+// Adds a realization of tt to mig, whose input i is driven by inputs[i];
+// returns false if a block could not be synthesized
+bool buildInto(MIG& mig, const std::string& tt, const std::vector<std::pair<int, int>>& inputs,
+               const Decomposer::BlockSynthesizer& block_synthesizer, int max_block_vars,
+               std::pair<int, int>& output) {
+    std::vector<int> support;
+    std::string reduced = Decomposer::shrinkToSupport(tt, support);
+    std::vector<std::pair<int, int>> reduced_inputs;
+    for (int v : support) reduced_inputs.push_back(inputs[v]);
+
+    DisjointDecomposition dec;
+    if (static_cast<int>(support.size()) > max_block_vars &&
+        Decomposer::findDisjointDecomposition(reduced, dec)) {
+        std::vector<std::pair<int, int>> bound_inputs, outer_inputs(1);
+        for (int v : dec.bound_vars) bound_inputs.push_back(reduced_inputs[v]);
+        if (!buildInto(mig, dec.inner, bound_inputs, block_synthesizer, max_block_vars,
+                       outer_inputs[0])) {
+            return false;
+        }
+        for (int v : dec.free_vars) outer_inputs.push_back(reduced_inputs[v]);
+        return buildInto(mig, dec.outer, outer_inputs, block_synthesizer, max_block_vars, output);
+    }
+
+    auto block = block_synthesizer(reduced);
+    if (!block) return false;
+    output = mig.compose(*block, reduced_inputs);
+    return true;
+}
+
+using Signal = std::pair<int, int>;  // (node, polarity), node 0 is constant 0
+
+// MAJ gate, folded when two fanins are constants
+Signal majority(MIG& mig, Signal a, Signal b, Signal c) {
+    Signal fanins[3] = {a, b, c};
+    for (int i = 0; i < 3; ++i) {
+        for (int j = i + 1; j < 3; ++j) {
+            if (fanins[i].first != 0 || fanins[j].first != 0) continue;
+            // M(0, 0, x) = 0, M(0, 1, x) = x
+            return fanins[i].second == fanins[j].second ? fanins[i] : fanins[3 - i - j];
+        }
+    }
+    return {mig.addGate({a.first, b.first, c.first}, {a.second, b.second, c.second}), 0};
+}
+
+} // namespace
+
+std::string Decomposer::shrinkToSupport(const std::string& tt, std::vector<int>& support) {
+    int n_vars = TruthTable::getNumVars(tt);
+    if (n_vars > kMaxVars) {
+        throw std::invalid_argument("Decomposition supports at most 6 inputs");
+    }
+    uint64_t packed = TruthTable::truthTableToBinary(tt);
+    support.clear();
+    for (int v = 0; v < n_vars; ++v) {
+        if (TruthTable::dependsOnVarPacked(packed, n_vars, v)) support.push_back(v);
+    }
+    return TruthTable::binaryToTruthTable(restrictTo(packed, n_vars, support),
+                                          static_cast<int>(support.size()));
+}
+
+bool Decomposer::findDisjointDecomposition(const std::string& tt, DisjointDecomposition& result) {
+    std::vector<int> support;
+    std::string reduced = shrinkToSupport(tt, support);
+    int m = static_cast<int>(support.size());
+    uint64_t packed = TruthTable::truthTableToBinary(reduced);
+
+    int best_cost = m + 1;
+    DisjointDecomposition candidate;
+    for (int bound_mask = 1; bound_mask < (1 << m) - 1; ++bound_mask) {
+        int bound_size = TruthTable::countOnesPacked(bound_mask);
+        if (bound_size < 2) continue;
+        int cost = std::max(bound_size, m - bound_size + 1);
+        if (cost >= best_cost) continue;
+        if (tryBoundSet(packed, m, bound_mask, candidate)) {
+            best_cost = cost;
+            result = candidate;
+        }
+    }
+    if (best_cost > m) return false;
+
+    // Back to the variable indices of tt
+    for (int& v : result.bound_vars) v = support[v];
+    for (int& v : result.free_vars) v = support[v];
+    return true;
+}
+
+std::unique_ptr<MIG> Decomposer::synthesize(const std::string& tt,
+                                            const BlockSynthesizer& block_synthesizer,
+                                            int max_block_vars) {
+    if (!TruthTable::validateTruthTable(tt)) {
+        throw std::invalid_argument("Invalid truth table: " + tt);
+    }
+    int n_vars = TruthTable::getNumVars(tt);
+    auto mig = std::make_unique<MIG>(n_vars);
+    std::vector<std::pair<int, int>> inputs;
+    for (int j = 0; j < n_vars; ++j) inputs.push_back({j + 1, 0});
+
+    std::pair<int, int> output;
+    if (!buildInto(*mig, tt, inputs, block_synthesizer, max_block_vars, output)) return nullptr;
+    mig->setOutput(output.first, output.second);
+    return mig;
+}
+
+std::unique_ptr<MIG> Decomposer::shannonUpperBound(const std::string& tt,
+                                                   const BlockSynthesizer& cofactor_synthesizer) {
+    if (!TruthTable::validateTruthTable(tt)) {
+        throw std::invalid_argument("Invalid truth table: " + tt);
+    }
+    int n_vars = TruthTable::getNumVars(tt);
+    if (n_vars > kMaxVars) {
+        throw std::invalid_argument("Decomposition supports at most 6 inputs");
+    }
+    uint64_t packed = TruthTable::truthTableToBinary(tt);
+    const uint64_t mask = tableMask(n_vars);
+    if (packed == 0 || packed == mask) {
+        auto mig = std::make_unique<MIG>(n_vars);
+        mig->setOutput(0, packed != 0);
+        return mig;
+    }
+
+    std::unique_ptr<MIG> best;
+    for (int v = 0; v < n_vars; ++v) {
+        if (!TruthTable::dependsOnVarPacked(packed, n_vars, v)) continue;
+        std::vector<int> rest;
+        std::vector<Signal> rest_inputs;
+        for (int u = 0; u < n_vars; ++u) {
+            if (u == v) continue;
+            rest.push_back(u);
+            rest_inputs.push_back({u + 1, 0});
+        }
+        uint64_t cofactors[2];
+        std::unique_ptr<MIG> blocks[2];
+        for (int value = 0; value <= 1; ++value) {
+            cofactors[value] = TruthTable::getCofactorPacked(packed, n_vars, v, value);
+            blocks[value] = cofactor_synthesizer(
+                TruthTable::binaryToTruthTable(restrictTo(cofactors[value], n_vars, rest), n_vars - 1));
+        }
+        if (!blocks[0] || !blocks[1]) continue;
+
+        auto mig = std::make_unique<MIG>(n_vars);
+        Signal f1 = mig->compose(*blocks[1], rest_inputs);
+        Signal f0 = mig->compose(*blocks[0], rest_inputs);
+        Signal x{v + 1, 0}, not_x{v + 1, 1};
+        Signal output;
+        if ((cofactors[0] & ~cofactors[1]) == 0) {
+            output = majority(*mig, x, f1, f0);
+        } else if ((cofactors[1] & ~cofactors[0]) == 0) {
+            output = majority(*mig, not_x, f1, f0);
+        } else {
+            output = majority(*mig, majority(*mig, x, f1, {0, 0}), majority(*mig, not_x, f0, {0, 0}), {0, 1});
+        }
+        mig->setOutput(output.first, output.second);
+        if (!best || mig->size() < best->size() ||
+            (mig->size() == best->size() && mig->depth() < best->depth())) {
+            best = std::move(mig);
+        }
+    }
+    return best;
+}
@@ -0,0 +1,55 @@
+#ifndef DECOMPOSITION_H
+#define DECOMPOSITION_H
+
+#include "mig_structure.h"
+#include "mig_synthesizer.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// f(x) = outer(inner(x_bound), x_free) with disjoint bound and free sets
+struct DisjointDecomposition {
+    std::vector<int> bound_vars;   // variable indices of f, ascending
+    std::vector<int> free_vars;
+    std::string inner;             // truth table over bound_vars
+    std::string outer;             // truth table over (inner, free_vars...)
+};
+
+// Disjoint-support decomposition of functions with up to 6 inputs, done with
+// bitwise cofactor tests on packed truth tables.
+class Decomposer {
+public:
+    using BlockSynthesizer = std::function<std::unique_ptr<MIG>(const std::string&)>;
+
+    // Restricts tt to the variables it depends on, which are stored in support
+    static std::string shrinkToSupport(const std::string& tt, std::vector<int>& support);
+
+    // Finds the decomposition with the smallest larger block. A single free
+    // variable is a top-level decomposition (AND, OR or XOR with a literal).
+    // Returns false if tt has none.
+    static bool findDisjointDecomposition(const std::string& tt, DisjointDecomposition& result);
+
+    // Decomposes tt recursively until the blocks have at most max_block_vars
+    // inputs, synthesizes every block and composes them into one MIG.
+    // Blocks that do not decompose further are synthesized as they are.
+    // Returns nullptr if a block cannot be synthesized.
+    static std::unique_ptr<MIG> synthesize(const std::string& tt,
+                                           const BlockSynthesizer& block_synthesizer = synthesizeOptimalMIG,
+                                           int max_block_vars = 4);
+
+    // Upper bound for exact synthesis from the Shannon expansion
+    //   f = x ? f1 : f0,
+    // each cofactor realized over the other inputs by cofactor_synthesizer
+    // (e.g. a database of (n-1)-input classes) and joined by
+    //   M(x, f1, f0)                        if f0 implies f1
+    //   M(!x, f1, f0)                       if f1 implies f0
+    //   M(M(x, f1, 0), M(!x, f0, 0), 1)     otherwise.
+    // Every input f depends on is tried as x and the smallest MIG (then the
+    // shallowest) is returned; nullptr if no input has both cofactors
+    // synthesized.
+    static std::unique_ptr<MIG> shannonUpperBound(const std::string& tt,
+                                                  const BlockSynthesizer& cofactor_synthesizer = synthesizeOptimalMIG);
+};
+
+#endif // DECOMPOSITION_H
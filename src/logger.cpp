@@ -0,0 +1,179 @@
+#include "logger.h"
+#include "utils.h"
+
+namespace {
+
+constexpr size_t kMaxBatch = 1024;
+
+const char* levelPrefix(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "DEBUG ";
+        case LogLevel::Warning: return "WARNING ";
+        case LogLevel::Error: return "ERROR ";
+        default: return "";
+    }
+}
+
+} // namespace
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger(size_t capacity) : ring(capacity), mask(capacity - 1) {
+    // Capacity must be a power of two for the index mask
+    for (size_t i = 0; i < capacity; ++i) {
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    writer = std::thread(&Logger::writerLoop, this);
+}
+
+Logger::~Logger() {
+    stopping.store(true);
+    wake.notify_one();
+    writer.join();
+    for (auto& file : files) std::fclose(file.second);
+}
+
+bool Logger::tryPush(Record& record) {
+    uint64_t pos = head.load(std::memory_order_relaxed);
+    while (true) {
+        Slot& slot = ring[pos & mask];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.record = std::move(record);
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;   // full
+        } else {
+            pos = head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool Logger::tryPop(Record& record) {
+    Slot& slot = ring[tail & mask];
+    if (slot.sequence.load(std::memory_order_acquire) != tail + 1) return false;
+    record = std::move(slot.record);
+    slot.sequence.store(tail + ring.size(), std::memory_order_release);
+    tail++;
+    return true;
+}
+
+void Logger::log(LogLevel level, const std::string& message, const std::string& logfile) {
+    if (static_cast<int>(level) < min_level.load(std::memory_order_relaxed)) return;
+
+    Record record{level, std::chrono::system_clock::now(), message, logfile};
+    while (!tryPush(record)) {
+        wake.notify_one();
+        std::this_thread::yield();
+    }
+    wake.notify_one();
+}
+
+bool Logger::logRateLimited(const std::string& key, const std::string& message, int interval_ms,
+                            const std::string& logfile) {
+    auto now = std::chrono::steady_clock::now();
+    uint64_t suppressed;
+    {
+        std::lock_guard<std::mutex> lock(throttle_mutex);
+        auto it = throttles.find(key);
+        if (it != throttles.end() && now - it->second.last < std::chrono::milliseconds(interval_ms)) {
+            it->second.suppressed++;
+            return false;
+        }
+        Throttle& throttle = throttles[key];
+        suppressed = throttle.suppressed;
+        throttle.last = now;
+        throttle.suppressed = 0;
+    }
+    if (suppressed > 0) {
+        log(LogLevel::Info, message + " (" + std::to_string(suppressed) + " similar suppressed)", logfile);
+    } else {
+        log(LogLevel::Info, message, logfile);
+    }
+    return true;
+}
+
+void Logger::flush() {
+    uint64_t target = head.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(wake_mutex);
+    wake.notify_one();
+    drained.wait(lock, [&]() { return flushed.load() >= target; });
+}
+
+void Logger::write(const Record& record) {
+    std::time_t seconds = std::chrono::system_clock::to_time_t(record.time);
+    if (seconds != stamp_second || stamp.empty()) {
+        std::tm timeinfo;
+#ifdef _WIN32
+        localtime_s(&timeinfo, &seconds);
+#else
+        localtime_r(&seconds, &timeinfo);
+#endif
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "[%Y-%m-%d %H:%M:%S] ", &timeinfo);
+        stamp = buffer;
+        stamp_second = seconds;
+    }
+
+    std::FILE*& file = files[record.logfile];
+    if (!file) {
+        size_t last_slash = record.logfile.find_last_of("/\\");
+        if (last_slash != std::string::npos) {
+            Utils::ensureDir(record.logfile.substr(0, last_slash));
+        }
+        file = std::fopen(record.logfile.c_str(), "a");
+    }
+    if (file) {
+        std::string line = stamp + levelPrefix(record.level) + record.message + "\n";
+        std::fwrite(line.data(), 1, line.size(), file);
+    }
+
+    // Debug messages only go to the file
+    if (record.level != LogLevel::Debug) {
+        std::FILE* console = record.level >= LogLevel::Warning ? stderr : stdout;
+        std::fwrite(record.message.data(), 1, record.message.size(), console);
+        std::fputc('\n', console);
+    }
+}
+
+void Logger::flushFiles() {
+    for (auto& file : files) {
+        if (file.second) std::fflush(file.second);
+    }
+    std::fflush(stdout);
+    std::fflush(stderr);
+}
+
+void Logger::writerLoop() {
+    Record record;
+    while (true) {
+        size_t written = 0;
+        while (written < kMaxBatch && tryPop(record)) {
+            write(record);
+            written++;
+        }
+        if (written > 0) {
+            // One flush per batch instead of one per message
+            flushFiles();
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex);
+                flushed.store(tail);
+            }
+            drained.notify_all();
+            continue;
+        }
+        if (stopping.load()) break;
+
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        // Producers notify without the lock, so a wakeup can be missed; the
+        // timeout bounds the delay when that happens
+        wake.wait_for(lock, std::chrono::milliseconds(50));
+    }
+}
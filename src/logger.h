@@ -0,0 +1,98 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class LogLevel { Debug = 0, Info = 1, Warning = 2, Error = 3 };
+
+// Debug messages cost nothing unless the build defines MIG_DEBUG_LOGGING
+#ifdef MIG_DEBUG_LOGGING
+#define MIG_LOG_DEBUG(message) Utils::logMessage((message), "logs/synthesis.log", LogLevel::Debug)
+#else
+#define MIG_LOG_DEBUG(message) ((void)0)
+#endif
+
+// Backend of Utils::logMessage. Callers only format their message and push it
+// into a bounded lock-free ring (Vyukov's sequence-numbered queue); one
+// background thread timestamps, writes and flushes, keeping every log file
+// open for the life of the process. Producers wait only while the ring is
+// full.
+class Logger {
+public:
+    static Logger& instance();
+
+    void log(LogLevel level, const std::string& message, const std::string& logfile);
+
+    // Logs at most one message per key every interval_ms; the next message
+    // that gets through reports how many were dropped. Returns whether this
+    // message was logged.
+    bool logRateLimited(const std::string& key, const std::string& message, int interval_ms,
+                        const std::string& logfile);
+
+    // Blocks until every message logged before the call is written out
+    void flush();
+
+    void setLevel(LogLevel level) { min_level.store(static_cast<int>(level)); }
+    LogLevel getLevel() const { return static_cast<LogLevel>(min_level.load()); }
+
+private:
+    struct Record {
+        LogLevel level;
+        std::chrono::system_clock::time_point time;
+        std::string message;
+        std::string logfile;
+    };
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        Record record;
+    };
+    struct Throttle {
+        std::chrono::steady_clock::time_point last;
+        uint64_t suppressed = 0;
+    };
+
+    explicit Logger(size_t capacity = 4096);
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    bool tryPush(Record& record);
+    bool tryPop(Record& record);
+    void writerLoop();
+    void write(const Record& record);
+    void flushFiles();
+
+    std::vector<Slot> ring;
+    size_t mask;
+    alignas(64) std::atomic<uint64_t> head{0};   // next slot to claim
+    alignas(64) uint64_t tail = 0;               // next slot to write, writer only
+    std::atomic<uint64_t> flushed{0};            // records written and flushed
+
+    std::atomic<int> min_level{static_cast<int>(LogLevel::Info)};
+    std::atomic<bool> stopping{false};
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+    std::condition_variable drained;
+
+    std::mutex throttle_mutex;
+    std::unordered_map<std::string, Throttle> throttles;
+
+    // Writer thread only
+    std::unordered_map<std::string, std::FILE*> files;
+    std::time_t stamp_second = 0;
+    std::string stamp;
+
+    std::thread writer;
+};
+
+#endif // LOGGER_H
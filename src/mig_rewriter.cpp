@@ -0,0 +1,337 @@
+#include "mig_rewriter.h"
+#include "profiler.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+// node << 1 | complemented; signal 0 is the constant 0
+using Signal = uint32_t;
+using Fanins = std::array<Signal, 3>;
+
+struct FaninsHash {
+    size_t operator()(const Fanins& f) const {
+        uint64_t h = ((uint64_t(f[0]) << 32) | f[1]) * 0x9E3779B97F4A7C15ULL;
+        h ^= (h >> 29) + f[2] * 0xC2B2AE3D27D4EB4FULL;
+        return h ^ (h >> 32);
+    }
+};
+
+// Structurally hashed MIG with nodes numbered like MIG: constant, inputs,
+// then gates in topological order
+struct Network {
+    int n_vars;
+    std::vector<Fanins> fanins;     // unused for the constant and inputs
+    std::vector<uint32_t> level;
+    std::vector<Signal> outputs;
+    std::unordered_map<Fanins, uint32_t, FaninsHash> table;
+
+    explicit Network(int vars) : n_vars(vars), fanins(vars + 1), level(vars + 1, 0) {}
+
+    uint32_t numNodes() const { return static_cast<uint32_t>(fanins.size()); }
+    int size() const { return static_cast<int>(fanins.size()) - n_vars - 1; }
+    bool isGate(Signal s) const { return (s >> 1) > static_cast<uint32_t>(n_vars); }
+    uint32_t levelOf(Signal s) const { return level[s >> 1]; }
+
+    // Fanins of the gate behind s; a complemented s is pushed into them
+    Fanins faninsOf(Signal s) const {
+        Fanins f = fanins[s >> 1];
+        if (s & 1) {
+            for (auto& x : f) x ^= 1;
+        }
+        return f;
+    }
+
+    int depth() const {
+        uint32_t d = 0;
+        for (Signal o : outputs) d = std::max(d, levelOf(o));
+        return static_cast<int>(d);
+    }
+
+    Signal create(Signal a, Signal b, Signal c) {
+        if (a > b) std::swap(a, b);
+        if (b > c) std::swap(b, c);
+        if (a > b) std::swap(a, b);
+        // Omega.M; complementary signals are adjacent once sorted
+        if (a == b || b == c) return b;
+        if ((a ^ 1) == b) return c;
+        if ((b ^ 1) == c) return a;
+        // Omega.I: keep at most one complemented fanin
+        Signal phase = 0;
+        if ((a & 1) + (b & 1) + (c & 1) >= 2) {
+            a ^= 1;
+            b ^= 1;
+            c ^= 1;
+            phase = 1;
+        }
+        Fanins key{a, b, c};
+        auto it = table.find(key);
+        if (it != table.end()) return (it->second << 1) | phase;
+        uint32_t node = numNodes();
+        fanins.push_back(key);
+        level.push_back(1 + std::max({levelOf(a), levelOf(b), levelOf(c)}));
+        table.emplace(key, node);
+        return (node << 1) | phase;
+    }
+
+    // Gates reachable from an output
+    std::vector<char> liveNodes() const {
+        std::vector<char> live(numNodes(), 0);
+        for (Signal o : outputs) live[o >> 1] = 1;
+        for (uint32_t v = numNodes(); v-- > static_cast<uint32_t>(n_vars) + 1;) {
+            if (!live[v]) continue;
+            for (Signal f : fanins[v]) live[f >> 1] = 1;
+        }
+        return live;
+    }
+
+    // Latest level of every node that keeps the current depth
+    std::vector<uint32_t> requiredTimes() const {
+        std::vector<uint32_t> required(numNodes(), std::numeric_limits<uint32_t>::max());
+        uint32_t d = depth();
+        for (Signal o : outputs) required[o >> 1] = d;
+        for (uint32_t v = numNodes(); v-- > static_cast<uint32_t>(n_vars) + 1;) {
+            if (required[v] == std::numeric_limits<uint32_t>::max()) continue;
+            for (Signal f : fanins[v]) required[f >> 1] = std::min(required[f >> 1], required[v] - 1);
+        }
+        return required;
+    }
+
+    std::vector<uint32_t> fanoutCounts() const {
+        std::vector<uint32_t> fanout(numNodes(), 0);
+        std::vector<char> live = liveNodes();
+        for (Signal o : outputs) fanout[o >> 1]++;
+        for (uint32_t v = n_vars + 1; v < numNodes(); ++v) {
+            if (!live[v]) continue;
+            for (Signal f : fanins[v]) fanout[f >> 1]++;
+        }
+        return fanout;
+    }
+};
+
+// Copies the live gates of old in topological order; rule(net, v, mapped)
+// builds old gate v in net, where mapped(s) is the new signal of old signal s
+template <typename Rule>
+Network rebuild(const Network& old, Rule rule) {
+    Network net(old.n_vars);
+    net.table.reserve(old.numNodes());
+    std::vector<char> live = old.liveNodes();
+    std::vector<Signal> map(old.numNodes());
+    for (int v = 0; v <= old.n_vars; ++v) map[v] = static_cast<Signal>(v) << 1;
+    auto mapped = [&map](Signal s) { return map[s >> 1] ^ (s & 1); };
+    for (uint32_t v = old.n_vars + 1; v < old.numNodes(); ++v) {
+        if (live[v]) map[v] = rule(net, v, mapped);
+    }
+    for (Signal o : old.outputs) net.outputs.push_back(mapped(o));
+    return net;
+}
+
+template <typename Mapped>
+Signal copyGate(Network& net, const Network& old, uint32_t v, const Mapped& mapped) {
+    const Fanins& f = old.fanins[v];
+    return net.create(mapped(f[0]), mapped(f[1]), mapped(f[2]));
+}
+
+Network compact(const Network& old) {
+    return rebuild(old, [&old](Network& net, uint32_t v, const auto& mapped) {
+        return copyGate(net, old, v, mapped);
+    });
+}
+
+struct RuleCounts {
+    uint64_t associativity = 0;
+    uint64_t complementary_associativity = 0;
+    uint64_t distributivity = 0;
+};
+
+// Moves the strictly deepest grandchild of M(a, b, c) one level up if one of
+// the rules lowers the gate; associativity is preferred as it adds no gates
+Signal pushUp(Network& net, Signal a, Signal b, Signal c, RuleCounts& counts) {
+    auto L = [&net](Signal s) { return net.levelOf(s); };
+    Signal s[3] = {a, b, c};
+    int i = L(a) >= L(b) ? (L(a) >= L(c) ? 0 : 2) : (L(b) >= L(c) ? 1 : 2);
+    Signal z = s[i], x = s[(i + 1) % 3], y = s[(i + 2) % 3];
+    if (!net.isGate(z) || L(x) >= L(z) || L(y) >= L(z)) return net.create(a, b, c);
+    Fanins g = net.faninsOf(z);
+    int k = L(g[0]) >= L(g[1]) ? (L(g[0]) >= L(g[2]) ? 0 : 2) : (L(g[1]) >= L(g[2]) ? 1 : 2);
+    Signal r = g[k], p = g[(k + 1) % 3], q = g[(k + 2) % 3];
+    if (L(p) >= L(r) || L(q) >= L(r)) return net.create(a, b, c);
+
+    uint32_t best = 1 + L(z);
+    int rule = 0;
+    Signal u = 0, inner = 0, outer = 0;
+    const Signal child_pair[2][2] = {{p, q}, {q, p}};
+    const Signal parent_pair[2][2] = {{x, y}, {y, x}};
+    for (const auto& cp : child_pair) {
+        for (const auto& pp : parent_pair) {
+            if (cp[0] == pp[0]) {
+                // M(pp1, u, M(cp1, u, r)) = M(r, u, M(cp1, u, pp1))
+                uint32_t level = 1 + std::max({L(r), L(cp[0]), 1 + std::max({L(cp[1]), L(cp[0]), L(pp[1])})});
+                if (level < best) {
+                    best = level;
+                    rule = 1;
+                    u = cp[0];
+                    inner = cp[1];
+                    outer = pp[1];
+                }
+            } else if (cp[0] == (pp[0] ^ 1)) {
+                // M(pp1, u, M(cp1, !u, r)) = M(r, pp1, M(cp1, pp1, u))
+                uint32_t level = 1 + std::max({L(r), L(pp[1]), 1 + std::max({L(cp[1]), L(pp[1]), L(pp[0])})});
+                if (level < best) {
+                    best = level;
+                    rule = 2;
+                    u = pp[1];
+                    inner = cp[1];
+                    outer = pp[0];
+                }
+            }
+        }
+    }
+    uint32_t shared = std::max(L(x), L(y));
+    uint32_t level = 1 + std::max({L(r), 1 + std::max(shared, L(p)), 1 + std::max(shared, L(q))});
+    if (level < best) rule = 3;
+
+    switch (rule) {
+    case 1:
+        counts.associativity++;
+        return net.create(r, u, net.create(inner, u, outer));
+    case 2:
+        counts.complementary_associativity++;
+        return net.create(r, u, net.create(inner, u, outer));
+    case 3:
+        counts.distributivity++;
+        return net.create(net.create(x, y, p), net.create(x, y, q), r);
+    default:
+        return net.create(a, b, c);
+    }
+}
+
+Network depthPass(const Network& old) {
+    std::vector<uint32_t> required = old.requiredTimes();
+    RuleCounts counts;
+    Network net = rebuild(old, [&](Network& net, uint32_t v, const auto& mapped) {
+        if (required[v] != old.level[v]) return copyGate(net, old, v, mapped);
+        const Fanins& f = old.fanins[v];
+        return pushUp(net, mapped(f[0]), mapped(f[1]), mapped(f[2]), counts);
+    });
+    MIG_PROFILE_COUNT("rewrite.associativity", counts.associativity);
+    MIG_PROFILE_COUNT("rewrite.complementary_associativity", counts.complementary_associativity);
+    MIG_PROFILE_COUNT("rewrite.distributivity", counts.distributivity);
+    return compact(net);
+}
+
+// Two of the three fanins shared by the (complement-adjusted) gates A and B;
+// u and v are the remaining ones
+bool sharedPair(const Fanins& A, const Fanins& B, Signal& x, Signal& y, Signal& u, Signal& v) {
+    for (int i = 0; i < 3; ++i) {
+        for (int j = i + 1; j < 3; ++j) {
+            int k = 3 - i - j;
+            for (int m = 0; m < 3; ++m) {
+                for (int n = 0; n < 3; ++n) {
+                    if (m == n || A[i] != B[m] || A[j] != B[n]) continue;
+                    x = A[i];
+                    y = A[j];
+                    u = A[k];
+                    v = B[3 - m - n];
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+Network areaPass(const Network& old) {
+    std::vector<uint32_t> fanout = old.fanoutCounts();
+    uint64_t applied = 0;
+    Network net = rebuild(old, [&](Network& net, uint32_t v, const auto& mapped) {
+        const Fanins& f = old.fanins[v];
+        for (int i = 0; i < 3; ++i) {
+            for (int j = i + 1; j < 3; ++j) {
+                Signal sa = f[i], sb = f[j], sz = f[3 - i - j];
+                if (!old.isGate(sa) || !old.isGate(sb) || (sa >> 1) == (sb >> 1)) continue;
+                if (fanout[sa >> 1] != 1 || fanout[sb >> 1] != 1) continue;
+                Signal x, y, u, w;
+                if (!sharedPair(old.faninsOf(sa), old.faninsOf(sb), x, y, u, w)) continue;
+                // M(M(x, y, u), M(x, y, w), z) = M(x, y, M(u, w, z)) if not deeper
+                Signal X = mapped(x), Y = mapped(y), U = mapped(u), W = mapped(w), Z = mapped(sz);
+                uint32_t before = 1 + std::max({net.levelOf(mapped(sa)), net.levelOf(mapped(sb)), net.levelOf(Z)});
+                uint32_t after = 1 + std::max({net.levelOf(X), net.levelOf(Y),
+                                               1 + std::max({net.levelOf(U), net.levelOf(W), net.levelOf(Z)})});
+                if (after > before) continue;
+                applied++;
+                return net.create(X, Y, net.create(U, W, Z));
+            }
+        }
+        return copyGate(net, old, v, mapped);
+    });
+    MIG_PROFILE_COUNT("rewrite.area_distributivity", applied);
+    return compact(net);
+}
+
+Network fromMIG(const MIG& mig) {
+    Network net(mig.n_vars);
+    net.table.reserve(mig.gates.size());
+    // Gate ids are dense, so a gate's fanins always precede it
+    std::vector<Signal> map(mig.n_vars + mig.gates.size() + 1);
+    for (int v = 0; v <= mig.n_vars; ++v) map[v] = static_cast<Signal>(v) << 1;
+    for (const auto& gate : mig.gates) {
+        if (gate.inputs.size() != 3) {
+            throw std::invalid_argument("Depth rewriting needs three-input majority gates");
+        }
+        Signal s[3];
+        for (int i = 0; i < 3; ++i) s[i] = map[gate.inputs[i]] ^ (gate.polarities[i] ? 1 : 0);
+        map[gate.id] = net.create(s[0], s[1], s[2]);
+    }
+    for (size_t o = 0; o < mig.outputs.size(); ++o) {
+        net.outputs.push_back(map[mig.outputs[o]] ^ (mig.output_polarities[o] ? 1 : 0));
+    }
+    return compact(net);
+}
+
+MIG toMIG(const Network& net) {
+    MIG mig(net.n_vars);
+    for (uint32_t v = net.n_vars + 1; v < net.numNodes(); ++v) {
+        const Fanins& f = net.fanins[v];
+        mig.addGate({int(f[0] >> 1), int(f[1] >> 1), int(f[2] >> 1)},
+                    {int(f[0] & 1), int(f[1] & 1), int(f[2] & 1)});
+    }
+    for (size_t o = 0; o < net.outputs.size(); ++o) {
+        Signal s = net.outputs[o];
+        if (o == 0) {
+            mig.setOutput(s >> 1, s & 1);
+        } else {
+            mig.addOutput(s >> 1, s & 1);
+        }
+    }
+    return mig;
+}
+
+} // namespace
+
+std::vector<RewritePass> MIGRewriter::optimizeDepth(MIG& mig, const RewriteOptions& options) {
+    MIG_PROFILE_SCOPE("rewrite.optimize_depth");
+    std::vector<RewritePass> passes;
+    Network net = fromMIG(mig);
+    passes.push_back({"strash", mig.depth(), mig.size(), net.depth(), net.size()});
+
+    auto run = [&](const char* name, Network (*pass)(const Network&)) {
+        RewritePass report{name, net.depth(), net.size(), 0, 0};
+        net = pass(net);
+        report.depth_after = net.depth();
+        report.size_after = net.size();
+        passes.push_back(report);
+    };
+    for (int round = 0; round < options.max_rounds; ++round) {
+        int depth = net.depth(), size = net.size();
+        run("depth", depthPass);
+        if (options.area_recovery) run("area", areaPass);
+        if (net.depth() == depth && net.size() >= size) break;
+    }
+    mig = toMIG(net);
+    return passes;
+}
@@ -0,0 +1,47 @@
+#ifndef MIG_REWRITER_H
+#define MIG_REWRITER_H
+
+#include "mig_structure.h"
+#include <string>
+#include <vector>
+
+// Depth and size of the MIG around one pass
+struct RewritePass {
+    std::string name;           // "strash", "depth" or "area"
+    int depth_before = 0;
+    int size_before = 0;
+    int depth_after = 0;
+    int size_after = 0;
+};
+
+struct RewriteOptions {
+    int max_rounds = 8;         // depth + area rounds, stops early without progress
+    bool area_recovery = true;
+};
+
+// Algebraic depth optimization with the majority axioms.
+//
+// Every pass rebuilds the graph in topological order into a structurally
+// hashed copy that keeps at most one complemented fanin per gate (inverter
+// propagation, Omega.I) and drops M(x, x, y) = x and M(x, !x, y) = y
+// (Omega.M); gates no output reaches disappear. On top of that:
+//
+//   depth  gates on a critical path (zero slack against per-node levels and
+//          required times) whose deepest fanin is a gate with a strictly
+//          deepest fanin z move z one level up when it lowers the gate:
+//            M(x, u, M(y, u, z))  = M(z, u, M(y, u, x))            Omega.A
+//            M(x, u, M(y, !u, z)) = M(z, x, M(y, x, u))   Psi.C then Omega.A
+//            M(x, y, M(u, v, z))  = M(M(x, y, u), M(x, y, v), z)   Omega.D
+//   area   M(M(x, y, u), M(x, y, v), z) = M(x, y, M(u, v, z)) (Omega.D right
+//          to left) where both inner gates have no other fanout and the
+//          level does not grow
+//
+// No pass increases a gate's level, so the depth never grows. Each pass is
+// one linear sweep plus hash lookups.
+class MIGRewriter {
+public:
+    // Rewrites every output of mig in place and returns one report per pass
+    static std::vector<RewritePass> optimizeDepth(MIG& mig, const RewriteOptions& options = RewriteOptions());
+};
+
+#endif // MIG_REWRITER_H
@@ -1,12 +1,13 @@
 #include "mig_structure.h"
+#include <algorithm>
 
 // ---------------- MIGGate ----------------
 
-int MIGGate::evaluate(const std::vector<int>& input_values) const {
+int MIGGate::evaluate(const std::vector<int>& node_values) const {
     assert(inputs.size() == polarities.size());
     int count = 0;
     for (size_t i = 0; i < inputs.size(); ++i) {
-        int val = input_values[inputs[i] - 1]; // assuming inputs are 1-based
+        int val = node_values[inputs[i]];
         if (polarities[i]) val = !val;
         count += val;
     }
@@ -26,47 +27,135 @@ std::string MIGGate::toText() const {
 
 // ---------------- MIG ----------------
 
-MIG::MIG(int vars) : n_vars(vars), output_gate(0), output_polarity(0) {}
+MIG::MIG(int vars) : n_vars(vars), outputs(1, 0), output_polarities(1, 0) {}
 
 int MIG::addGate(const std::vector<int>& inputs, const std::vector<int>& polarities) {
-    int gate_id = static_cast<int>(gates.size()) + 1;
-    gates.emplace_back(gate_id, inputs, polarities);
+    int gate_id = n_vars + static_cast<int>(gates.size()) + 1;
+    if (polarities.empty()) {
+        gates.emplace_back(gate_id, inputs, std::vector<int>(inputs.size(), 0));
+    } else {
+        gates.emplace_back(gate_id, inputs, polarities);
+    }
     return gate_id;
 }
 
 void MIG::setOutput(int gate_id, int polarity) {
-    output_gate = gate_id;
-    output_polarity = polarity;
+    outputs[0] = gate_id;
+    output_polarities[0] = polarity;
+}
+
+int MIG::addOutput(int node, int polarity) {
+    outputs.push_back(node);
+    output_polarities.push_back(polarity);
+    return static_cast<int>(outputs.size()) - 1;
+}
+
+std::pair<int, int> MIG::compose(const MIG& sub, const std::vector<std::pair<int, int>>& inputs) {
+    assert(static_cast<int>(inputs.size()) == sub.n_vars);
+    // (node, polarity) in this MIG for every node of sub
+    std::vector<std::pair<int, int>> mapped(sub.n_vars + sub.gates.size() + 1, {0, 0});
+    for (int j = 0; j < sub.n_vars; ++j)
+        mapped[j + 1] = inputs[j];
+    for (const auto& g : sub.gates) {
+        std::vector<int> fanins, polarities;
+        for (size_t i = 0; i < g.inputs.size(); ++i) {
+            fanins.push_back(mapped[g.inputs[i]].first);
+            polarities.push_back(mapped[g.inputs[i]].second ^ g.polarities[i]);
+        }
+        mapped[g.id] = {addGate(fanins, polarities), 0};
+    }
+    const auto& out = mapped[sub.outputs[0]];
+    return {out.first, out.second ^ sub.output_polarities[0]};
 }
 
-int MIG::evaluate(const std::vector<int>& input_values) const {
-    assert(!gates.empty());
-    // simple MAJ-3 with single gate
-    int val = gates.back().evaluate(input_values);
-    return output_polarity ? !val : val;
+int MIG::evaluate(const std::vector<int>& input_values, int output) const {
+    std::vector<int> node_values(n_vars + gates.size() + 1, 0);
+    for (int j = 0; j < n_vars; ++j)
+        node_values[j + 1] = input_values[j];
+    for (const auto& g : gates)
+        node_values[g.id] = g.evaluate(node_values);
+    int val = node_values[outputs[output]];
+    return output_polarities[output] ? !val : val;
 }
 
-std::string MIG::getTruthTable() const {
+std::string MIG::getTruthTable(int output) const {
     int n = 1 << n_vars;
     std::string tt;
     for (int i = 0; i < n; ++i) {
+        // x1 is the most significant bit of the row index
         std::vector<int> inputs(n_vars);
         for (int j = 0; j < n_vars; ++j)
-            inputs[j] = (i >> j) & 1;
-        tt += std::to_string(evaluate(inputs));
+            inputs[j] = (i >> (n_vars - 1 - j)) & 1;
+        tt += std::to_string(evaluate(inputs, output));
     }
     return tt;
 }
 
-int MIG::depth() const { return 1; } // single MAJ-3
+int MIG::depth() const {
+    // Constants and inputs are on level 0
+    std::vector<int> level(n_vars + gates.size() + 1, 0);
+    for (const auto& g : gates) {
+        int max_level = 0;
+        for (int in : g.inputs)
+            max_level = std::max(max_level, level[in]);
+        level[g.id] = max_level + 1;
+    }
+    int max_depth = 0;
+    for (int out : outputs)
+        max_depth = std::max(max_depth, level[out]);
+    return max_depth;
+}
 
 bool MIG::validate(const std::string& truth_table) const {
     return getTruthTable() == truth_table;
 }
 
+bool MIG::validate(const std::vector<std::string>& truth_tables) const {
+    if (truth_tables.size() != outputs.size()) return false;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        if (getTruthTable(static_cast<int>(i)) != truth_tables[i]) return false;
+    }
+    return true;
+}
+
 std::string MIG::toText() const {
     std::stringstream ss;
     for (const auto& g : gates)
         ss << g.toText() << "\n";
+    for (size_t i = 0; i < outputs.size(); ++i)
+        ss << "Output: " << (output_polarities[i] ? "¬" : "") << "x" << outputs[i] << "\n";
+    return ss.str();
+}
+
+std::string MIG::toCompact() const {
+    std::stringstream ss;
+    ss << gates.size();
+    for (const auto& g : gates) {
+        assert(g.inputs.size() == 3);
+        ss << " " << g.inputs[0] << " " << g.inputs[1] << " " << g.inputs[2]
+           << " " << g.polarities[0] << " " << g.polarities[1] << " " << g.polarities[2];
+    }
+    ss << " " << outputs[0] << " " << output_polarities[0];
     return ss.str();
 }
+
+bool MIG::fromCompact(std::istream& in, int n_vars, MIG& mig) {
+    int n_gates = 0;
+    if (!(in >> n_gates) || n_gates < 0) return false;
+    mig = MIG(n_vars);
+    for (int g = 0; g < n_gates; ++g) {
+        std::vector<int> inputs(3), polarities(3);
+        if (!(in >> inputs[0] >> inputs[1] >> inputs[2]
+                 >> polarities[0] >> polarities[1] >> polarities[2])) {
+            return false;
+        }
+        for (int in_node : inputs) {
+            if (in_node < 0 || in_node > n_vars + g) return false;
+        }
+        mig.addGate(inputs, polarities);
+    }
+    int out = 0, pol = 0;
+    if (!(in >> out >> pol) || out < 0 || out > n_vars + n_gates) return false;
+    mig.setOutput(out, pol);
+    return true;
+}
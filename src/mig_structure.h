@@ -5,7 +5,11 @@
 #include <string>
 #include <sstream>
 #include <cassert>
+#include <istream>
+#include <utility>
 
+// Node ids: 0 is the constant 0, 1..n_vars are the primary inputs and
+// n_vars+1.. are the gates in the order they were added.
 class MIGGate {
 public:
     int id;
@@ -15,7 +19,8 @@ public:
     MIGGate(int gate_id, const std::vector<int>& in, const std::vector<int>& pol = {})
         : id(gate_id), inputs(in), polarities(pol) {}
 
-    int evaluate(const std::vector<int>& input_values) const;
+    // node_values is indexed by node id
+    int evaluate(const std::vector<int>& node_values) const;
     std::string toText() const;
 };
 
@@ -23,21 +28,39 @@ class MIG {
 public:
     int n_vars;
     std::vector<MIGGate> gates;
-    int output_gate;
-    int output_polarity;
+    // Node id and polarity of every output; a new MIG has one output (constant 0)
+    std::vector<int> outputs;
+    std::vector<int> output_polarities;
 
     MIG(int vars = 3);
 
+    // Returns the node id of the new gate
     int addGate(const std::vector<int>& inputs, const std::vector<int>& polarities = {});
+    // Sets the first output
     void setOutput(int gate_id, int polarity);
+    // Appends an output and returns its index
+    int addOutput(int node, int polarity);
+    int numOutputs() const { return static_cast<int>(outputs.size()); }
 
-    int evaluate(const std::vector<int>& input_values) const;
-    std::string getTruthTable() const;
+    // Copies the gates of sub into this MIG, driving input i of sub with the
+    // (node, polarity) pair inputs[i]. Returns the (node, polarity) of the
+    // first output of sub.
+    std::pair<int, int> compose(const MIG& sub, const std::vector<std::pair<int, int>>& inputs);
+
+    int evaluate(const std::vector<int>& input_values, int output = 0) const;
+    std::string getTruthTable(int output = 0) const;
     int size() const { return static_cast<int>(gates.size()); }
+    // Deepest output
     int depth() const;
     bool validate(const std::string& truth_table) const;
+    bool validate(const std::vector<std::string>& truth_tables) const;
     std::string toText() const;
 
+    // Single-line encoding of the first output:
+    //   <gates> (<a> <b> <c> <pa> <pb> <pc>)* <output> <polarity>
+    std::string toCompact() const;
+    static bool fromCompact(std::istream& in, int n_vars, MIG& mig);
+
     const std::vector<MIGGate>& getGates() const { return gates; }
 };
 
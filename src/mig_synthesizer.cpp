@@ -1,15 +1,502 @@
 #include "mig_synthesizer.h"
+#include "npn_classifier.h"
+#include "profiler.h"
+#include "truth_table.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+constexpr int kMaxVars = 6;
+constexpr int kMaxGates = 12;
+constexpr int kUnbounded = kMaxGates + 1;
+// Candidates of the first budgeted runs of a bounded search
+constexpr uint64_t kFirstBudget = 1 << 16;
+
+// One MAJ gate with fanins a < b < c (MAJ is commutative) and at most one
+// complemented fanin: pol 0 = none, 1..3 = fanin[pol - 1]. Two or three
+// complemented fanins are normalized away by MAJ(¬a,¬b,¬c) = ¬MAJ(a,b,c),
+// the output complement being absorbed by the fanout edge.
+struct Step {
+    int fanin[3];
+    int pol;
+};
+
+// Colexicographic order on (c, b, a, pol)
+bool colexLess(const Step& x, const Step& y) {
+    if (x.fanin[2] != y.fanin[2]) return x.fanin[2] < y.fanin[2];
+    if (x.fanin[1] != y.fanin[1]) return x.fanin[1] < y.fanin[1];
+    if (x.fanin[0] != y.fanin[0]) return x.fanin[0] < y.fanin[0];
+    return x.pol < y.pol;
+}
+
+// Depth-first enumeration of k-gate MIGs in topological order that realize a
+// set of targets (each as a node or its complement), optionally restricted to
+// a maximum depth.
+//
+// Symmetry breaking: independent neighbouring gates can be swapped, so gates
+// are required to be in strictly increasing colex order; and for inputs xi, xj
+// (i < j) that every target is symmetric in, xj may not be used before xi.
+// Both constraints keep the lexicographically smallest optimum reachable.
+class ExactSearch {
+public:
+    ExactSearch(int n_vars, const std::vector<uint64_t>& functions, bool symmetry_breaking,
+                std::chrono::steady_clock::time_point deadline, uint64_t search_limit = ~0ULL)
+        : n_vars(n_vars), outputs(functions), symmetry_breaking(symmetry_breaking),
+          deadline(deadline), search_limit(search_limit) {
+        mask = (n_vars == kMaxVars) ? ~0ULL : ((1ULL << (1 << n_vars)) - 1);
+        funcs.assign(n_vars + 1, 0);
+        for (int j = 0; j < n_vars; ++j)
+            funcs[j + 1] = TruthTable::varMask(n_vars, j);
+
+        // Outputs equal up to complement share one target
+        for (uint64_t f : outputs) {
+            if (findTarget(f) < 0) targets.push_back(f);
+        }
+        for (size_t t = 0; t < targets.size(); ++t) {
+            for (int j = 0; j <= n_vars; ++j) {
+                if (funcs[j] == targets[t] || funcs[j] == (~targets[t] & mask))
+                    trivially_covered.insert(static_cast<int>(t));
+            }
+        }
+    }
+
+    // xj may only appear in a gate once xi has been used
+    void addInputOrder(int i, int j) { input_order.push_back({i + 1, j + 1}); }
+
+    // Every output is a constant or a literal
+    bool isTrivial() const { return trivially_covered.size() == targets.size(); }
+
+    // False if there is no solution or the search stopped early: on timeout
+    // (also once search_limit gates were placed over all runs), or after
+    // placing max_candidates gates in this run (sets out_of_budget)
+    bool run(int gates, int max_depth = kUnbounded, uint64_t max_candidates = ~0ULL) {
+        num_gates = gates;
+        candidate_limit = std::min<uint64_t>(max_candidates == ~0ULL ? ~0ULL : candidates + max_candidates,
+                                             search_limit);
+        out_of_budget = false;
+        depth_limit = max_depth;
+        funcs.resize(n_vars + 1 + num_gates);
+        levels.assign(n_vars + 1 + num_gates, 0);
+        uses.assign(n_vars + 1 + num_gates, 0);
+        steps.assign(num_gates, Step{{0, 0, 0}, 0});
+        dangling = 0;
+        covered.assign(targets.size(), 0);
+        for (int t : trivially_covered) covered[t] = 1;
+        uncovered = static_cast<int>(targets.size() - trivially_covered.size());
+        if (num_gates == 0) return uncovered == 0;
+        return dfs(0);
+    }
+
+    std::unique_ptr<MIG> build() const {
+        auto mig = std::make_unique<MIG>(n_vars);
+        for (const auto& s : steps) {
+            std::vector<int> pol = {s.pol == 1, s.pol == 2, s.pol == 3};
+            mig->addGate({s.fanin[0], s.fanin[1], s.fanin[2]}, pol);
+        }
+        for (size_t t = 0; t < outputs.size(); ++t) {
+            int node = 0;
+            while (funcs[node] != outputs[t] && funcs[node] != (~outputs[t] & mask)) node++;
+            int polarity = (funcs[node] == outputs[t]) ? 0 : 1;
+            if (t == 0) {
+                mig->setOutput(node, polarity);
+            } else {
+                mig->addOutput(node, polarity);
+            }
+        }
+        return mig;
+    }
+
+    int solutionDepth() const { return build()->depth(); }
+
+    uint64_t candidates = 0;
+    uint64_t expanded = 0;          // candidates that survived every pruning rule
+    bool timed_out = false;
+    bool out_of_budget = false;
+
+private:
+    // Index of the target equal to h or its complement, -1 if none
+    int findTarget(uint64_t h) const {
+        uint64_t h_neg = ~h & mask;
+        for (size_t t = 0; t < targets.size(); ++t) {
+            if (targets[t] == h || targets[t] == h_neg) return static_cast<int>(t);
+        }
+        return -1;
+    }
+
+    bool inputOrderOk(const Step& s) const {
+        for (const auto& [u, v] : input_order) {
+            if (uses[u] > 0) continue;
+            bool has_u = false, has_v = false;
+            for (int f : s.fanin) {
+                has_u |= (f == u);
+                has_v |= (f == v);
+            }
+            if (has_v && !has_u) return false;
+        }
+        return true;
+    }
+
+    // Under a depth limit a duplicate only helps if it is not deeper
+    bool isDuplicate(uint64_t h, int node, int level) const {
+        uint64_t h_neg = ~h & mask;
+        bool bounded = depth_limit < kUnbounded;
+        for (int j = 0; j < node; ++j) {
+            if ((funcs[j] == h || funcs[j] == h_neg) && (!bounded || levels[j] <= level))
+                return true;
+        }
+        return false;
+    }
+
+    bool dfs(int i) {
+        const int node = n_vars + 1 + i;
+        const int remaining = num_gates - 1 - i;
+        int c_start = (symmetry_breaking && i > 0) ? steps[i - 1].fanin[2] : 2;
+
+        for (int c = c_start; c < node; ++c) {
+            for (int b = 1; b < c; ++b) {
+                for (int a = 0; a < b; ++a) {
+                    for (int pol = 0; pol < 4; ++pol) {
+                        Step s{{a, b, c}, pol};
+                        if (symmetry_breaking && i > 0 && !colexLess(steps[i - 1], s)) continue;
+                        if (!inputOrderOk(s)) continue;
+                        int level = 1 + std::max({levels[a], levels[b], levels[c]});
+                        if (level > depth_limit) continue;
+
+                        if ((++candidates & 0x3FFF) == 0 &&
+                            std::chrono::steady_clock::now() > deadline) {
+                            timed_out = true;
+                            return false;
+                        }
+                        if (candidates >= candidate_limit) {
+                            if (candidates >= search_limit) {
+                                timed_out = true;
+                            } else {
+                                out_of_budget = true;
+                            }
+                            return false;
+                        }
+
+                        uint64_t fa = funcs[a] ^ (pol == 1 ? mask : 0);
+                        uint64_t fb = funcs[b] ^ (pol == 2 ? mask : 0);
+                        uint64_t fc = funcs[c] ^ (pol == 3 ? mask : 0);
+                        uint64_t h = (fa & fb) | (fa & fc) | (fb & fc);
+
+                        // The last gate has no fanout, so it must be an output;
+                        // gates after the last output would be dangling
+                        int hit = findTarget(h);
+                        if (hit >= 0 && covered[hit]) continue;
+                        int uncovered_after = uncovered - (hit >= 0 ? 1 : 0);
+                        if (remaining == 0 ? uncovered_after != 0 : uncovered_after == 0) continue;
+                        if (uncovered_after > remaining) continue;
+
+                        // Every gate that is not an output must have a fanout.
+                        // Each later gate consumes up to three dangling gates
+                        // and leaves itself dangling unless it is an output.
+                        int newly_used = 0;
+                        for (int f : s.fanin) {
+                            if (f > n_vars && uses[f] == 0 && findTarget(funcs[f]) < 0) newly_used++;
+                        }
+                        int dangling_after = dangling - newly_used + (hit >= 0 ? 0 : 1);
+                        if (dangling_after > 2 * remaining + uncovered_after) continue;
+
+                        if (remaining == 0) {
+                            expanded++;
+                            steps[i] = s;
+                            funcs[node] = h;
+                            levels[node] = level;
+                            return true;
+                        }
+                        if (isDuplicate(h, node, level)) continue;
+                        expanded++;
+
+                        steps[i] = s;
+                        funcs[node] = h;
+                        levels[node] = level;
+                        for (int f : s.fanin) uses[f]++;
+                        int saved_dangling = dangling;
+                        dangling = dangling_after;
+                        if (hit >= 0) covered[hit] = 1;
+                        uncovered = uncovered_after;
+
+                        if (dfs(i + 1)) return true;
+
+                        if (hit >= 0) covered[hit] = 0;
+                        uncovered = uncovered_after + (hit >= 0 ? 1 : 0);
+                        dangling = saved_dangling;
+                        for (int f : s.fanin) uses[f]--;
+                        if (timed_out || out_of_budget) return false;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    int n_vars;
+    std::vector<uint64_t> outputs;
+    std::vector<uint64_t> targets;  // distinct outputs
+    uint64_t mask;
+    bool symmetry_breaking;
+    std::chrono::steady_clock::time_point deadline;
+    uint64_t search_limit;
+    std::set<int> trivially_covered;
+
+    int num_gates = 0;
+    int depth_limit = kUnbounded;
+    uint64_t candidate_limit = ~0ULL;
+    int dangling = 0;               // gates without fanout that are no output
+    int uncovered = 0;
+    std::vector<char> covered;
+    std::vector<uint64_t> funcs;    // packed function of every node
+    std::vector<int> levels;        // depth of every node
+    std::vector<int> uses;          // fanout count of every node
+    std::vector<Step> steps;
+    std::vector<std::pair<int, int>> input_order;
+};
+
+// Groups of inputs that every truth table is symmetric in, each sorted ascending
+std::vector<std::vector<int>> symmetryGroups(const std::vector<std::string>& truth_tables, int n_vars) {
+    std::set<std::pair<int, int>> common;
+    for (size_t t = 0; t < truth_tables.size(); ++t) {
+        auto pairs = NPNClassifier::getSymmetricVariables(truth_tables[t]);
+        std::set<std::pair<int, int>> current(pairs.begin(), pairs.end());
+        if (t == 0) {
+            common = current;
+            continue;
+        }
+        for (auto it = common.begin(); it != common.end();) {
+            it = current.count(*it) ? std::next(it) : common.erase(it);
+        }
+    }
+
+    std::vector<int> parent(n_vars);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&](int x) {
+        while (parent[x] != x) x = parent[x] = parent[parent[x]];
+        return x;
+    };
+    for (const auto& [i, j] : common) {
+        parent[find(j)] = find(i);
+    }
+
+    std::vector<std::vector<int>> groups(n_vars);
+    for (int v = 0; v < n_vars; ++v) groups[find(v)].push_back(v);
+
+    std::vector<std::vector<int>> result;
+    for (auto& g : groups) {
+        if (g.size() > 1) result.push_back(g);
+    }
+    return result;
+}
+
+// A depth-d MIG reaches at most 3^d inputs
+int depthLowerBound(int support_size) {
+    int depth = 0;
+    for (int reach = 1; reach < support_size; reach *= 3) depth++;
+    return depth;
+}
+
+// Unfolding a depth-d MIG into a tree never needs more than (3^d - 1) / 2 gates
+int maxGatesForDepth(int depth) {
+    if (depth >= kUnbounded) return kMaxGates;
+    int tree_gates = 0;
+    for (int level = 0, width = 1; level < depth && tree_gates < kMaxGates; ++level, width *= 3)
+        tree_gates += width;
+    return std::min(tree_gates, kMaxGates);
+}
+
+// Validates the truth tables and sets up a search carrying their common input
+// symmetry constraints. Gate-free functions are returned through trivial instead.
+std::unique_ptr<ExactSearch> prepareSearch(const std::vector<std::string>& truth_tables,
+                                           bool symmetry_breaking, int timeout_ms, uint64_t candidate_limit,
+                                           SynthesisStats& stats, std::unique_ptr<MIG>& trivial) {
+    if (truth_tables.empty()) {
+        throw std::invalid_argument("No truth table to synthesize");
+    }
+    std::vector<uint64_t> functions;
+    for (const auto& tt : truth_tables) {
+        if (!TruthTable::validateTruthTable(tt) || tt.size() != truth_tables[0].size()) {
+            throw std::invalid_argument("Invalid truth table: " + tt);
+        }
+        functions.push_back(TruthTable::truthTableToBinary(tt));
+    }
+    int n_vars = TruthTable::getNumVars(truth_tables[0]);
+    if (n_vars > kMaxVars) {
+        throw std::invalid_argument("Exact synthesis supports at most 6 inputs");
+    }
+
+    stats = SynthesisStats();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    auto search = std::make_unique<ExactSearch>(n_vars, functions, symmetry_breaking, deadline,
+                                                candidate_limit > 0 ? candidate_limit : ~0ULL);
+
+    // Constants and literals need no gate
+    if (search->isTrivial()) {
+        search->run(0);
+        trivial = search->build();
+        return search;
+    }
+
+    if (symmetry_breaking) {
+        for (const auto& group : symmetryGroups(truth_tables, n_vars)) {
+            stats.symmetry_groups++;
+            for (size_t k = 1; k < group.size(); ++k) {
+                search->addInputOrder(group[k - 1], group[k]);
+            }
+        }
+    }
+    return search;
+}
+
+// Profiler counters for one finished search
+void countCandidates(const ExactSearch& search) {
+    MIG_PROFILE_COUNT("synthesis.candidates", search.candidates);
+    MIG_PROFILE_COUNT("synthesis.pruned", search.candidates - search.expanded);
+}
+
+} // namespace
 
 std::unique_ptr<MIG> MIGSynthesizer::synthesizeSizeOptimal(const std::string& truth_table) {
-    auto mig = std::make_unique<MIG>(3); // 3 variables for MAJ-3
-    std::vector<int> inputs = {1, 2, 3};
-    std::vector<int> polarities = {0, 0, 0};
-    int gate_id = mig->addGate(inputs, polarities);
-    mig->setOutput(gate_id, 0);
-    return mig;
+    return synthesizeMultiOutput({truth_table});
+}
+
+std::unique_ptr<MIG> MIGSynthesizer::synthesizeMultiOutput(const std::vector<std::string>& truth_tables) {
+    std::unique_ptr<MIG> trivial;
+    MIG_PROFILE_SCOPE("synthesis.exact");
+    auto search = prepareSearch(truth_tables, symmetry_breaking, timeout_ms, candidate_limit, stats, trivial);
+    if (trivial) return trivial;
+
+    for (int k = 1; k <= kMaxGates; ++k) {
+        bool found = search->run(k);
+        stats.candidates = search->candidates;
+        if (found || search->timed_out) {
+            countCandidates(*search);
+            if (found) return search->build();
+            break;
+        }
+    }
+    stats.timed_out = true;
+    return nullptr;
+}
+
+std::unique_ptr<MIG> MIGSynthesizer::synthesizeSizeOptimal(const std::string& truth_table,
+                                                          const MIG& upper_bound) {
+    std::unique_ptr<MIG> trivial;
+    MIG_PROFILE_SCOPE("synthesis.exact");
+    auto search = prepareSearch({truth_table}, symmetry_breaking, timeout_ms, candidate_limit, stats, trivial);
+    if (trivial) return trivial;
+    if (upper_bound.numOutputs() != 1 || !upper_bound.validate(truth_table)) {
+        throw std::invalid_argument("Upper bound does not realize " + truth_table);
+    }
+    stats.upper_bound = upper_bound.size();
+
+    // Sizes below lo are impossible and best has hi gates. A bottom-up run
+    // at lo either proves lo impossible or is optimal, so the search ends
+    // when lo reaches hi. Large sizes are hard to rule out but easy to hit,
+    // so while a bottom-up run exceeds its candidate budget a top-down run
+    // with the same budget looks for hi - 1 gates, and both budgets double.
+    // Once hi - 1 is ruled out as well (the search drops redundant gates, so
+    // that says nothing about smaller sizes) bottom-up runs without budget.
+    auto best = std::make_unique<MIG>(upper_bound);
+    int lo = 1, hi = upper_bound.size();
+    bool top_down = true;
+    uint64_t budget = kFirstBudget;
+    while (lo < hi && lo <= kMaxGates) {
+        if (search->run(lo, kUnbounded, top_down ? budget : ~0ULL)) {
+            best = search->build();
+            hi = lo;
+            break;
+        }
+        if (search->timed_out) break;
+        if (!search->out_of_budget) {
+            ++lo;
+            continue;
+        }
+        top_down = hi - 1 > lo && hi - 1 <= kMaxGates;
+        if (top_down && search->run(hi - 1, kUnbounded, budget)) {
+            MIG_PROFILE_COUNT("synthesis.bound_improved", 1);
+            best = search->build();
+            --hi;
+            continue;
+        }
+        if (search->timed_out) break;
+        if (!search->out_of_budget) top_down = false;
+        budget *= 2;
+    }
+
+    stats.candidates = search->candidates;
+    stats.timed_out = lo < hi;
+    countCandidates(*search);
+    return best;
+}
+
+std::vector<std::unique_ptr<MIG>> MIGSynthesizer::synthesizeParetoFront(const std::string& truth_table) {
+    MIG_PROFILE_SCOPE("synthesis.pareto");
+    std::vector<std::unique_ptr<MIG>> front;
+    std::unique_ptr<MIG> trivial;
+    auto search = prepareSearch({truth_table}, symmetry_breaking, timeout_ms, candidate_limit, stats, trivial);
+    if (trivial) {
+        front.push_back(std::move(trivial));
+        return front;
+    }
+
+    // Walk the front from the size optimum towards the depth optimum. Every
+    // size below k is already known to miss the current depth limit, so each
+    // point resumes from the previous size instead of restarting at one gate.
+    int min_depth = depthLowerBound(static_cast<int>(TruthTable::getSupport(truth_table).size()));
+    int depth_limit = kUnbounded;
+    int k = 1;
+    while (true) {
+        bool found = false;
+        for (; k <= maxGatesForDepth(depth_limit); ++k) {
+            found = search->run(k, depth_limit);
+            if (found || search->timed_out) break;
+        }
+        if (!found) break;
+
+        // Smallest depth reachable with k gates
+        auto best = search->build();
+        int depth = search->solutionDepth();
+        while (depth > min_depth && search->run(k, depth - 1)) {
+            best = search->build();
+            depth = search->solutionDepth();
+        }
+        front.push_back(std::move(best));
+        if (search->timed_out || depth == min_depth) break;
+
+        depth_limit = depth - 1;
+        ++k;
+    }
+
+    stats.candidates = search->candidates;
+    stats.timed_out = search->timed_out || front.empty();
+    countCandidates(*search);
+    return front;
+}
+
+std::unique_ptr<MIG> MIGSynthesizer::synthesizeDepthOptimal(const std::string& truth_table) {
+    auto front = synthesizeParetoFront(truth_table);
+    if (front.empty() || stats.timed_out) return nullptr;
+    return std::move(front.back());
 }
 
 std::unique_ptr<MIG> synthesizeOptimalMIG(const std::string& truth_table) {
     MIGSynthesizer synthesizer;
     return synthesizer.synthesizeSizeOptimal(truth_table);
 }
+
+std::vector<std::unique_ptr<MIG>> synthesizeParetoMIGs(const std::string& truth_table) {
+    MIGSynthesizer synthesizer;
+    return synthesizer.synthesizeParetoFront(truth_table);
+}
+
+std::unique_ptr<MIG> synthesizeMultiOutputMIG(const std::vector<std::string>& truth_tables) {
+    MIGSynthesizer synthesizer;
+    return synthesizer.synthesizeMultiOutput(truth_tables);
+}
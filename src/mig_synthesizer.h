@@ -2,16 +2,66 @@
 #define MIG_SYNTHESIZER_H
 
 #include "mig_structure.h"
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
+
+// Counters collected by the most recent synthesis call
+struct SynthesisStats {
+    uint64_t candidates = 0;     // gates placed during the search
+    int symmetry_groups = 0;     // input groups with more than one variable
+    int upper_bound = 0;         // gates of the seed of a bounded search, 0 without one
+    bool timed_out = false;
+};
 
 class MIGSynthesizer {
 public:
-    MIGSynthesizer(int timeout_ms = 60000) {}
+    MIGSynthesizer(int timeout_ms = 60000) : timeout_ms(timeout_ms) {}
+
+    // Exact search for the minimum number of MAJ gates (up to 6 inputs).
+    // Returns nullptr when the timeout expires before a solution is found.
     std::unique_ptr<MIG> synthesizeSizeOptimal(const std::string& truth_table);
+
+    // The same search bounded from above by a known realization of the
+    // function (e.g. Decomposer::shannonUpperBound). Only smaller sizes are
+    // searched, and when a size is not settled quickly the search also tries
+    // to shrink the bound top-down. On timeout the smallest MIG found so far
+    // is returned and getStats().timed_out is set. Throws
+    // std::invalid_argument if upper_bound does not realize truth_table.
+    std::unique_ptr<MIG> synthesizeSizeOptimal(const std::string& truth_table, const MIG& upper_bound);
+
+    // One MIG with an output per truth table (all over the same inputs) that
+    // minimizes the total number of shared MAJ gates
+    std::unique_ptr<MIG> synthesizeMultiOutput(const std::vector<std::string>& truth_tables);
+
+    // Minimum depth, and minimum size among the MIGs of that depth
+    std::unique_ptr<MIG> synthesizeDepthOptimal(const std::string& truth_table);
+
+    // All Pareto-optimal (size, depth) points ordered by increasing size and
+    // decreasing depth. On timeout the points found so far are returned and
+    // getStats().timed_out is set.
+    std::vector<std::unique_ptr<MIG>> synthesizeParetoFront(const std::string& truth_table);
+
+    // Symmetry breaking (colex gate order, lex order of symmetric inputs) is
+    // on by default; disabling it only exists to measure its effect.
+    void setSymmetryBreaking(bool enabled) { symmetry_breaking = enabled; }
+    // Stops every search after placing this many gates, reported like a
+    // timeout; 0 (the default) leaves only the timeout. Unlike the timeout it
+    // does not depend on the speed of the machine.
+    void setCandidateLimit(uint64_t limit) { candidate_limit = limit; }
+    const SynthesisStats& getStats() const { return stats; }
+
+private:
+    int timeout_ms;
+    bool symmetry_breaking = true;
+    uint64_t candidate_limit = 0;
+    SynthesisStats stats;
 };
 
-// Wrapper
+// Wrappers
 std::unique_ptr<MIG> synthesizeOptimalMIG(const std::string& truth_table);
+std::vector<std::unique_ptr<MIG>> synthesizeParetoMIGs(const std::string& truth_table);
+std::unique_ptr<MIG> synthesizeMultiOutputMIG(const std::vector<std::string>& truth_tables);
 
 #endif // MIG_SYNTHESIZER_H
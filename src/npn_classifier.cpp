@@ -1,7 +1,12 @@
 #include "npn_classifier.h"
 #include "truth_table.h"
+#include "npn_kernels.h"
+#include "npn_shuffle.h"
+#include "profiler.h"
+#include "walsh_spectrum.h"
 #include <algorithm>
 #include <numeric>
+#include <stdexcept>
 
 std::string NPNClassifier::applyNegationPattern(const std::string& tt, 
                                                const std::vector<int>& neg_inputs, 
@@ -57,36 +62,59 @@ std::string NPNClassifier::applyPermutation(const std::string& tt,
     return new_tt;
 }
 
+namespace {
+
+// Transforms examined by one exact canonization: n! * 2^n * 2
+uint64_t transformCount(int n_vars) {
+    return npn_kernels::factorial(n_vars) << (n_vars + 1);
+}
+
+} // namespace
+
 std::string NPNClassifier::getNPNRepresentative(const std::string& tt) {
-    int n_vars = TruthTable::getNumVars(tt);
-    std::string min_tt = tt;
-    uint64_t min_value = TruthTable::truthTableToBinary(tt);
+    size_t length = tt.length();
+    if (length == 0 || (length & (length - 1)) != 0 || length > 64) {
+        throw std::invalid_argument("Invalid truth table length");
+    }
+    int n_vars = __builtin_ctzll(length);
+    uint64_t representative = canonizePacked(TruthTable::truthTableToBinary(tt), n_vars);
+    return TruthTable::binaryToTruthTable(representative, n_vars);
+}
 
-    std::vector<int> perm(n_vars);
-    std::iota(perm.begin(), perm.end(), 0);
+uint64_t NPNClassifier::canonizePacked(uint64_t tt, int n_vars) {
+    uint64_t representative;
+    canonizeBatch(&tt, &representative, 1, n_vars);
+    return representative;
+}
 
-    do {
-        for (int neg_mask = 0; neg_mask < (1 << n_vars); ++neg_mask) {
-            std::vector<int> neg_inputs(n_vars);
-            for (int i = 0; i < n_vars; ++i) {
-                neg_inputs[i] = (neg_mask >> i) & 1;
-            }
-            for (int neg_output = 0; neg_output <= 1; ++neg_output) {
-                std::string transformed = applyPermutation(tt, perm);
-                transformed = applyNegationPattern(transformed, neg_inputs, neg_output);
-                uint64_t value = TruthTable::truthTableToBinary(transformed);
-                if (value < min_value) {
-                    min_value = value;
-                    min_tt = transformed;
-                }
-            }
-        }
-    } while (std::next_permutation(perm.begin(), perm.end()));
-    
-    return min_tt;
+void NPNClassifier::canonizeBatch(const uint64_t* tables, uint64_t* representatives, size_t count,
+                                  int n_vars) {
+    using namespace npn_kernels;
+    switch (n_vars) {
+    case 0: Canonizer<0>::batch(tables, representatives, count); break;
+    case 1: Canonizer<1>::batch(tables, representatives, count); break;
+    case 2: Canonizer<2>::batch(tables, representatives, count); break;
+    case 3: Canonizer<3>::batch(tables, representatives, count); break;
+    case 4: NPNShuffle::batch(tables, representatives, count); break;
+    case 5: Canonizer<5>::batch(tables, representatives, count); break;
+    case 6: Canonizer<6>::batch(tables, representatives, count); break;
+    default:
+        throw std::invalid_argument("Exact NPN canonization supports at most 6 variables");
+    }
+    MIG_PROFILE_COUNT("npn.canonizations", count);
+    MIG_PROFILE_COUNT("npn.transforms", count * transformCount(n_vars));
 }
 
 bool NPNClassifier::areNPNEquivalent(const std::string& tt1, const std::string& tt2) {
+    if (tt1.length() != tt2.length()) return false;
+    // Spectral signatures reject most inequivalent pairs before canonizing
+    if (TruthTable::validateTruthTable(tt1) && tt1.length() <= 64) {
+        int n_vars = __builtin_ctzll(tt1.length());
+        if (!WalshSpectrum::mayBeEquivalent(TruthTable::truthTableToBinary(tt1),
+                                            TruthTable::truthTableToBinary(tt2), n_vars)) {
+            return false;
+        }
+    }
     return getNPNRepresentative(tt1) == getNPNRepresentative(tt2);
 }
 
@@ -119,3 +147,86 @@ std::vector<std::pair<int, int>> NPNClassifier::getSymmetricVariables(const std:
     }
     return sym_pairs;
 }
+
+WideTruthTable NPNClassifier::getSemiCanonicalForm(const WideTruthTable& tt, int max_tie_steps) {
+    MIG_PROFILE_COUNT("npn.semi_canonizations", 1);
+    int n_vars = tt.numVars();
+    uint64_t ones = tt.countOnes();
+    uint64_t half = (1ULL << n_vars) / 2;
+
+    WideTruthTable best = tt;
+    bool have_best = false;
+    // Output phase: fewer ones than zeros; a balanced function tries both
+    for (int neg_output = 0; neg_output <= 1; ++neg_output) {
+        bool negate = ones > half;
+        if (neg_output) {
+            if (ones != half) break;
+            negate = true;
+        }
+        WideTruthTable form = tt;
+        if (negate) form.complement();
+
+        // Input phases: the positive cofactor holds at least as many ones
+        std::vector<uint64_t> keys(n_vars);
+        std::vector<bool> phase_tie(n_vars);
+        for (int v = 0; v < n_vars; ++v) {
+            uint64_t ones0 = form.countOnesCofactor(v, 0);
+            uint64_t ones1 = form.countOnesCofactor(v, 1);
+            if (ones0 > ones1) {
+                form.flipVar(v);
+                std::swap(ones0, ones1);
+            }
+            keys[v] = ones1;
+            phase_tie[v] = ones0 == ones1;
+        }
+
+        // Sort inputs by key with adjacent swaps; neither flips nor swaps
+        // change the other inputs' cofactor counts
+        for (int i = 1; i < n_vars; ++i) {
+            for (int j = i; j > 0 && keys[j - 1] > keys[j]; --j) {
+                form.swapVars(j - 1, j);
+                std::swap(keys[j - 1], keys[j]);
+                std::vector<bool>::swap(phase_tie[j - 1], phase_tie[j]);
+            }
+        }
+
+        // Tie-breaking: keep flips of undecided phases and swaps of equal keys
+        // while they lower the table
+        int steps = 0;
+        bool improved = true;
+        while (improved && steps < max_tie_steps) {
+            improved = false;
+            for (int v = 0; v < n_vars && steps < max_tie_steps; ++v) {
+                if (!phase_tie[v]) continue;
+                WideTruthTable candidate = form;
+                candidate.flipVar(v);
+                if (candidate < form) {
+                    form = std::move(candidate);
+                    improved = true;
+                    steps++;
+                }
+            }
+            for (int v = 0; v + 1 < n_vars && steps < max_tie_steps; ++v) {
+                if (keys[v] != keys[v + 1]) continue;
+                WideTruthTable candidate = form;
+                candidate.swapVars(v, v + 1);
+                if (candidate < form) {
+                    form = std::move(candidate);
+                    std::vector<bool>::swap(phase_tie[v], phase_tie[v + 1]);
+                    improved = true;
+                    steps++;
+                }
+            }
+        }
+
+        if (!have_best || form < best) {
+            best = std::move(form);
+            have_best = true;
+        }
+    }
+    return best;
+}
+
+uint64_t NPNClassifier::semiCanonicalHash(const WideTruthTable& tt) {
+    return getSemiCanonicalForm(tt).hash();
+}
@@ -2,6 +2,9 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <cstddef>
+#include <cstdint>
+#include "truth_table.h"
 
 class NPNClassifier {
 public:
@@ -12,8 +15,16 @@ public:
     static std::string applyPermutation(const std::string& tt, 
                                        const std::vector<int>& perm);
 
+    // Lexicographically smallest truth table of the class, for up to 6
+    // variables; throws std::invalid_argument otherwise
     static std::string getNPNRepresentative(const std::string& tt);
 
+    // Packed (bit i = row i) form of getNPNRepresentative
+    static uint64_t canonizePacked(uint64_t tt, int n_vars);
+    // Canonizes count packed tables of n_vars inputs, dispatching to the
+    // kernel for n_vars once for the whole batch
+    static void canonizeBatch(const uint64_t* tables, uint64_t* representatives, size_t count, int n_vars);
+
     static bool areNPNEquivalent(const std::string& tt1, const std::string& tt2);
 
     static std::vector<std::string> findNPNClasses(const std::vector<std::string>& truth_tables);
@@ -21,4 +32,15 @@ public:
     static bool checkSymmetry(const std::string& tt, int var1, int var2);
 
     static std::vector<std::pair<int, int>> getSymmetricVariables(const std::string& tt);
+
+    // Semi-canonical NPN form for wide functions (exact canonization is
+    // factorial in n). Output and input phases are fixed by onset counts and
+    // cofactor onset counts, inputs are sorted by cofactor count, and inputs
+    // these signatures cannot tell apart are settled by at most max_tie_steps
+    // improving flips and swaps. The result is always NPN-equivalent to tt;
+    // equivalent functions usually, but not always, get the same form.
+    static WideTruthTable getSemiCanonicalForm(const WideTruthTable& tt, int max_tie_steps = 32);
+
+    // Database key of the semi-canonical form
+    static uint64_t semiCanonicalHash(const WideTruthTable& tt);
 };
@@ -0,0 +1,479 @@
+#include "npn_database.h"
+#include "npn_classifier.h"
+#include "npn_matcher.h"
+#include "record_writer.h"
+#include "truth_table.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kMagic[8] = {'M', 'I', 'G', 'N', 'P', 'N', 'D', 'B'};
+const char kCompressedMagic[8] = {'M', 'I', 'G', 'N', 'P', 'N', 'D', 'Z'};
+constexpr uint32_t kVersion = 1;
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+// Bounds-checked; a corrupt block reads as exhausted instead of overrunning
+bool getVarint(const uint8_t*& pos, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; pos < end && shift < 64; shift += 7) {
+        uint8_t byte = *pos++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Sorted by packed representative, duplicates dropped
+std::vector<const DatabaseClass*> sortClasses(const std::vector<DatabaseClass>& classes, int& n_vars) {
+    std::vector<const DatabaseClass*> sorted;
+    for (const auto& cls : classes) sorted.push_back(&cls);
+    std::sort(sorted.begin(), sorted.end(), [](const DatabaseClass* a, const DatabaseClass* b) {
+        return TruthTable::truthTableToBinary(a->representative) <
+               TruthTable::truthTableToBinary(b->representative);
+    });
+    sorted.erase(std::unique(sorted.begin(), sorted.end(),
+                             [](const DatabaseClass* a, const DatabaseClass* b) {
+                                 return a->representative == b->representative;
+                             }),
+                 sorted.end());
+
+    n_vars = sorted.empty() ? 0 : TruthTable::getNumVars(sorted[0]->representative);
+    for (const DatabaseClass* cls : sorted) {
+        if (TruthTable::getNumVars(cls->representative) != n_vars) {
+            throw std::runtime_error("Mixed variable counts in database: " + cls->representative);
+        }
+        for (const auto& mig : cls->points) {
+            for (const auto& g : mig.getGates()) {
+                if (g.inputs.size() != 3) {
+                    throw std::runtime_error("Only MAJ-3 gates can be stored");
+                }
+            }
+        }
+    }
+    return sorted;
+}
+
+void writeFile(const std::string& filepath, const std::vector<std::pair<const void*, size_t>>& sections) {
+    size_t last_slash = filepath.find_last_of("/\\");
+    if (last_slash != std::string::npos) {
+        Utils::ensureDir(filepath.substr(0, last_slash));
+    }
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open file for writing: " + filepath);
+    }
+    for (const auto& section : sections) {
+        file.write(static_cast<const char*>(section.first), section.second);
+    }
+}
+
+// "¬x12" or "x12" -> (12, polarity)
+bool parseNodeRef(const std::string& token, int& node, int& polarity) {
+    static const std::string neg = "¬";
+    size_t pos = 0;
+    polarity = 0;
+    if (token.compare(0, neg.size(), neg) == 0) {
+        polarity = 1;
+        pos = neg.size();
+    }
+    if (pos >= token.size() || token[pos] != 'x') return false;
+    try {
+        node = std::stoi(token.substr(pos + 1));
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+NPNDatabase::NPNDatabase(const std::string& filepath) {
+#ifdef _WIN32
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("File not found: " + filepath);
+    }
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    length = buffer.size();
+#else
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("File not found: " + filepath);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+        close(fd);
+        throw std::runtime_error("Invalid database: " + filepath);
+    }
+    length = static_cast<size_t>(st.st_size);
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        throw std::runtime_error("Cannot map database: " + filepath);
+    }
+    data = static_cast<const char*>(mapped);
+#endif
+
+    header = reinterpret_cast<const Header*>(data);
+    if (length >= sizeof(CompressedHeader) &&
+        std::memcmp(header->magic, kCompressedMagic, sizeof(kCompressedMagic)) == 0) {
+        const auto* compressed = reinterpret_cast<const CompressedHeader*>(data);
+        if (compressed->version != kVersion ||
+            length != sizeof(CompressedHeader) + compressed->num_blocks * sizeof(BlockIndex) +
+                          compressed->payload_bytes) {
+            release();
+            throw std::runtime_error("Invalid database: " + filepath);
+        }
+        n_vars = static_cast<int>(compressed->n_vars);
+        num_classes = static_cast<size_t>(compressed->num_classes);
+        block_index = reinterpret_cast<const BlockIndex*>(data + sizeof(CompressedHeader));
+        payload = reinterpret_cast<const uint8_t*>(block_index + compressed->num_blocks);
+        return;
+    }
+    if (length < sizeof(Header) || std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 ||
+        header->version != kVersion ||
+        length != sizeof(Header) + header->num_classes * sizeof(ClassRecord) +
+                      header->num_points * sizeof(PointRecord) +
+                      header->num_nodes * sizeof(NodeRecord)) {
+        release();
+        throw std::runtime_error("Invalid database: " + filepath);
+    }
+    n_vars = static_cast<int>(header->n_vars);
+    num_classes = static_cast<size_t>(header->num_classes);
+    class_records = reinterpret_cast<const ClassRecord*>(data + sizeof(Header));
+    point_records = reinterpret_cast<const PointRecord*>(class_records + header->num_classes);
+    node_records = reinterpret_cast<const NodeRecord*>(point_records + header->num_points);
+}
+
+NPNDatabase::~NPNDatabase() {
+    release();
+}
+
+void NPNDatabase::release() {
+#ifdef _WIN32
+    buffer.clear();
+#else
+    if (data) munmap(const_cast<char*>(data), length);
+#endif
+    data = nullptr;
+}
+
+MIG NPNDatabase::decodePoint(const PointRecord& point) const {
+    MIG mig(numVars());
+    for (uint32_t g = 0; g < point.num_gates; ++g) {
+        const NodeRecord& node = node_records[point.first_node + g];
+        mig.addGate({node.fanin[0], node.fanin[1], node.fanin[2]},
+                    {node.polarities & 1, (node.polarities >> 1) & 1, (node.polarities >> 2) & 1});
+    }
+    mig.setOutput(point.output, point.output_polarity);
+    return mig;
+}
+
+bool NPNDatabase::find(const std::string& representative, DatabaseClass& result) const {
+    if (static_cast<int>(representative.size()) != (1 << numVars())) return false;
+    uint64_t key = TruthTable::truthTableToBinary(representative);
+    result.representative = representative;
+    if (block_index) return findCompressed(key, result);
+
+    const ClassRecord* end = class_records + num_classes;
+    const ClassRecord* it = std::lower_bound(
+        class_records, end, key,
+        [](const ClassRecord& record, uint64_t value) { return record.representative < value; });
+    if (it == end || it->representative != key) return false;
+
+    result.points.clear();
+    for (uint32_t p = 0; p < it->num_points; ++p) {
+        result.points.push_back(decodePoint(point_records[it->first_point + p]));
+    }
+    return true;
+}
+
+bool NPNDatabase::findFunction(const std::string& truth_table, MIG& mig) const {
+    if (static_cast<int>(truth_table.size()) != (1 << numVars())) return false;
+    DatabaseClass cls;
+    NPNTransform transform;
+    if (!find(NPNClassifier::getNPNRepresentative(truth_table), cls) || cls.points.empty() ||
+        !NPNMatcher::match(cls.representative, truth_table, transform)) {
+        return false;
+    }
+    // Input j of the representative reads input perm[j] of truth_table
+    std::vector<std::pair<int, int>> inputs;
+    for (int j = 0; j < n_vars; ++j) {
+        int k = transform.perm[j];
+        inputs.push_back({k + 1, transform.neg_inputs[k]});
+    }
+    mig = MIG(n_vars);
+    auto output = mig.compose(cls.points[0], inputs);
+    mig.setOutput(output.first, output.second ^ transform.neg_output);
+    return true;
+}
+
+bool NPNDatabase::findCompressed(uint64_t key, DatabaseClass& result) const {
+    const auto* compressed = reinterpret_cast<const CompressedHeader*>(data);
+    const BlockIndex* end = block_index + compressed->num_blocks;
+    // Last block whose first representative is <= key
+    const BlockIndex* block = std::upper_bound(
+        block_index, end, key,
+        [](uint64_t value, const BlockIndex& b) { return value < b.first_representative; });
+    if (block == block_index) return false;
+    --block;
+
+    const uint8_t* pos = payload + block->offset;
+    const uint8_t* block_end = pos + block->length;
+    uint64_t rep = block->first_representative;
+    for (uint32_t c = 0; c < block->num_classes; ++c) {
+        uint64_t delta, num_points;
+        if (!getVarint(pos, block_end, delta) || !getVarint(pos, block_end, num_points)) return false;
+        rep += delta;
+        if (rep > key) return false;
+        bool match = rep == key;
+        if (match) result.points.clear();
+
+        for (uint64_t p = 0; p < num_points; ++p) {
+            uint64_t num_gates, literal;
+            if (!getVarint(pos, block_end, num_gates)) return false;
+            MIG mig(n_vars);
+            for (uint64_t g = 0; g < num_gates; ++g) {
+                std::vector<int> inputs(3), polarities(3);
+                for (int i = 0; i < 3; ++i) {
+                    if (!getVarint(pos, block_end, literal)) return false;
+                    inputs[i] = static_cast<int>(literal >> 1);
+                    polarities[i] = static_cast<int>(literal & 1);
+                }
+                if (match) mig.addGate(inputs, polarities);
+            }
+            if (!getVarint(pos, block_end, literal)) return false;
+            if (match) {
+                mig.setOutput(static_cast<int>(literal >> 1), static_cast<int>(literal & 1));
+                result.points.push_back(mig);
+            }
+        }
+        if (match) return true;
+    }
+    return false;
+}
+
+std::vector<DatabaseClass> NPNDatabase::parseText(const std::string& text) {
+    std::vector<DatabaseClass> classes;
+    std::istringstream in(text);
+    std::string line;
+    bool point_open = false;
+
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string keyword;
+        if (!(fields >> keyword)) continue;
+
+        if (keyword == "CLASS") {
+            // The representative is the last field ("CLASS <rep>" or "CLASS <i>: <rep>")
+            std::string field, rep;
+            while (fields >> field) rep = field;
+            if (!TruthTable::validateTruthTable(rep)) {
+                throw std::runtime_error("Invalid class line: " + line);
+            }
+            classes.push_back({rep, {}});
+            point_open = false;
+            continue;
+        }
+        if (classes.empty() || keyword == "---") {
+            point_open = false;
+            continue;
+        }
+
+        DatabaseClass& cls = classes.back();
+        int n_vars = TruthTable::getNumVars(cls.representative);
+        if (keyword == "POINT") {
+            cls.points.emplace_back(n_vars);
+            point_open = true;
+        } else if (keyword == "Gate" || keyword == "Output:") {
+            if (!point_open) {
+                cls.points.emplace_back(n_vars);
+                point_open = true;
+            }
+            MIG& mig = cls.points.back();
+            int node = 0, polarity = 0;
+            if (keyword == "Output:") {
+                std::string ref;
+                if (!(fields >> ref) || !parseNodeRef(ref, node, polarity)) {
+                    throw std::runtime_error("Invalid output line: " + line);
+                }
+                mig.setOutput(node, polarity);
+                continue;
+            }
+            size_t open = line.find("MAJ(");
+            size_t close = line.find(')', open);
+            if (open == std::string::npos || close == std::string::npos) {
+                throw std::runtime_error("Invalid gate line: " + line);
+            }
+            std::istringstream refs(line.substr(open + 4, close - open - 4));
+            std::vector<int> inputs, polarities;
+            std::string ref;
+            while (std::getline(refs, ref, ',')) {
+                ref.erase(0, ref.find_first_not_of(' '));
+                if (!parseNodeRef(ref, node, polarity)) {
+                    throw std::runtime_error("Invalid gate line: " + line);
+                }
+                inputs.push_back(node);
+                polarities.push_back(polarity);
+            }
+            mig.addGate(inputs, polarities);
+        }
+        // TIME and Size/Depth summary lines carry nothing to keep
+    }
+    return classes;
+}
+
+bool NPNDatabase::isRecordStream(const std::string& data) {
+    return data.size() >= sizeof(RecordWriter::StreamHeader) && data.compare(0, 8, "MIGNPNRS") == 0;
+}
+
+std::vector<DatabaseClass> NPNDatabase::parseRecords(const std::string& data) {
+    if (!isRecordStream(data)) {
+        throw std::runtime_error("Not a record stream");
+    }
+    RecordWriter::StreamHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    int n_vars = static_cast<int>(header.n_vars);
+
+    std::vector<DatabaseClass> classes;
+    size_t pos = sizeof(header);
+    auto read = [&](void* out, size_t size) {
+        if (pos + size > data.size()) return false;
+        std::memcpy(out, data.data() + pos, size);
+        pos += size;
+        return true;
+    };
+
+    RecordWriter::StreamClass record;
+    while (read(&record, sizeof(record))) {
+        DatabaseClass cls{TruthTable::binaryToTruthTable(record.representative, n_vars), {}};
+        bool complete = true;
+        for (uint32_t p = 0; p < record.num_points && complete; ++p) {
+            RecordWriter::StreamPoint point;
+            complete = read(&point, sizeof(point));
+            MIG mig(n_vars);
+            for (uint16_t g = 0; g < point.num_gates && complete; ++g) {
+                NodeRecord node;
+                complete = read(&node, sizeof(node));
+                mig.addGate({node.fanin[0], node.fanin[1], node.fanin[2]},
+                            {node.polarities & 1, (node.polarities >> 1) & 1,
+                             (node.polarities >> 2) & 1});
+            }
+            mig.setOutput(point.output, point.output_polarity);
+            cls.points.push_back(mig);
+        }
+        if (!complete) break;
+        classes.push_back(std::move(cls));
+    }
+    return classes;
+}
+
+void NPNDatabase::writeBinary(const std::vector<DatabaseClass>& classes, const std::string& filepath) {
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    int n_vars = 0;
+    auto sorted = sortClasses(classes, n_vars);
+    header.n_vars = static_cast<uint32_t>(n_vars);
+
+    std::vector<ClassRecord> class_records;
+    std::vector<PointRecord> point_records;
+    std::vector<NodeRecord> node_records;
+    for (const DatabaseClass* cls : sorted) {
+        class_records.push_back({TruthTable::truthTableToBinary(cls->representative),
+                                 static_cast<uint32_t>(point_records.size()),
+                                 static_cast<uint32_t>(cls->points.size())});
+        for (const auto& mig : cls->points) {
+            point_records.push_back({static_cast<uint32_t>(node_records.size()),
+                                     static_cast<uint16_t>(mig.size()),
+                                     static_cast<uint8_t>(mig.outputs[0]),
+                                     static_cast<uint8_t>(mig.output_polarities[0])});
+            for (const auto& g : mig.getGates()) {
+                NodeRecord node{};
+                for (int i = 0; i < 3; ++i) {
+                    node.fanin[i] = static_cast<uint8_t>(g.inputs[i]);
+                    node.polarities |= static_cast<uint8_t>(g.polarities[i] << i);
+                }
+                node_records.push_back(node);
+            }
+        }
+    }
+    header.num_classes = class_records.size();
+    header.num_points = point_records.size();
+    header.num_nodes = node_records.size();
+
+    writeFile(filepath, {{&header, sizeof(header)},
+                         {class_records.data(), class_records.size() * sizeof(ClassRecord)},
+                         {point_records.data(), point_records.size() * sizeof(PointRecord)},
+                         {node_records.data(), node_records.size() * sizeof(NodeRecord)}});
+}
+
+void NPNDatabase::writeCompressed(const std::vector<DatabaseClass>& classes, const std::string& filepath,
+                                  int block_classes) {
+    if (block_classes < 1) {
+        throw std::invalid_argument("Blocks must hold at least one class");
+    }
+    CompressedHeader header{};
+    std::memcpy(header.magic, kCompressedMagic, sizeof(kCompressedMagic));
+    header.version = kVersion;
+    int n_vars = 0;
+    auto sorted = sortClasses(classes, n_vars);
+    header.n_vars = static_cast<uint32_t>(n_vars);
+    header.num_classes = sorted.size();
+    header.block_classes = static_cast<uint32_t>(block_classes);
+
+    std::vector<BlockIndex> index;
+    std::string payload;
+    uint64_t previous = 0;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        uint64_t rep = TruthTable::truthTableToBinary(sorted[i]->representative);
+        if (i % block_classes == 0) {
+            if (!index.empty()) index.back().length = static_cast<uint32_t>(payload.size() - index.back().offset);
+            index.push_back({rep, payload.size(), 0, 0});
+            previous = rep;
+        }
+        index.back().num_classes++;
+
+        putVarint(payload, rep - previous);
+        previous = rep;
+        putVarint(payload, sorted[i]->points.size());
+        for (const auto& mig : sorted[i]->points) {
+            putVarint(payload, mig.size());
+            for (const auto& g : mig.getGates()) {
+                for (int k = 0; k < 3; ++k) {
+                    putVarint(payload, static_cast<uint64_t>(g.inputs[k]) * 2 + g.polarities[k]);
+                }
+            }
+            putVarint(payload, static_cast<uint64_t>(mig.outputs[0]) * 2 + mig.output_polarities[0]);
+        }
+    }
+    if (!index.empty()) index.back().length = static_cast<uint32_t>(payload.size() - index.back().offset);
+    header.num_blocks = static_cast<uint32_t>(index.size());
+    header.payload_bytes = payload.size();
+
+    writeFile(filepath, {{&header, sizeof(header)},
+                         {index.data(), index.size() * sizeof(BlockIndex)},
+                         {payload.data(), payload.size()}});
+}
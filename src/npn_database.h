@@ -0,0 +1,121 @@
+#ifndef NPN_DATABASE_H
+#define NPN_DATABASE_H
+
+#include "mig_structure.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One class of a database: its representative and the Pareto points stored
+// for it, the first being the size-optimal MIG
+struct DatabaseClass {
+    std::string representative;
+    std::vector<MIG> points;
+};
+
+// Binary NPN class database, opened read-only through mmap.
+//
+// Layout (native byte order, every section naturally aligned):
+//   Header
+//   ClassRecord[num_classes]   sorted by packed representative
+//   PointRecord[num_points]
+//   NodeRecord[num_nodes]
+//
+// Compressed layout, for databases too large to keep in fixed-size records:
+//   CompressedHeader
+//   BlockIndex[num_blocks]     first representative of every block, ascending
+//   block payloads, each a run of classes coded as
+//     varint representative delta (from the previous class in the block,
+//            or from the block's first representative)
+//     varint num_points, and per point: varint num_gates,
+//            3 varint literals (node * 2 + complement) per gate,
+//            varint output literal
+// A lookup binary-searches the index and decodes at most one block.
+class NPNDatabase {
+public:
+    struct Header {
+        char magic[8];          // "MIGNPNDB"
+        uint32_t version;
+        uint32_t n_vars;
+        uint64_t num_classes;
+        uint64_t num_points;
+        uint64_t num_nodes;
+    };
+    struct ClassRecord {
+        uint64_t representative;    // packed, bit i = tt[i]
+        uint32_t first_point;
+        uint32_t num_points;
+    };
+    struct PointRecord {
+        uint32_t first_node;
+        uint16_t num_gates;
+        uint8_t output;
+        uint8_t output_polarity;
+    };
+    struct NodeRecord {
+        uint8_t fanin[3];
+        uint8_t polarities;         // bit i complements fanin[i]
+    };
+    struct CompressedHeader {
+        char magic[8];          // "MIGNPNDZ"
+        uint32_t version;
+        uint32_t n_vars;
+        uint64_t num_classes;
+        uint32_t num_blocks;
+        uint32_t block_classes;     // classes per block, the last may hold fewer
+        uint64_t payload_bytes;
+    };
+    struct BlockIndex {
+        uint64_t first_representative;
+        uint64_t offset;            // from the start of the payload
+        uint32_t num_classes;
+        uint32_t length;
+    };
+
+    explicit NPNDatabase(const std::string& filepath);
+    ~NPNDatabase();
+    NPNDatabase(const NPNDatabase&) = delete;
+    NPNDatabase& operator=(const NPNDatabase&) = delete;
+
+    int numVars() const { return n_vars; }
+    size_t size() const { return num_classes; }
+    bool isCompressed() const { return block_index != nullptr; }
+
+    // Binary search for the representative; false if it is not stored
+    bool find(const std::string& representative, DatabaseClass& result) const;
+
+    // First point of the class of any function, rewired onto the function
+    // through the NPN transform from the representative; false if the class
+    // is not stored or has no point
+    bool findFunction(const std::string& truth_table, MIG& mig) const;
+
+    // Parses the text format written by the compute drivers:
+    //   CLASS <rep> / [POINT <size> <depth>] / Gate lines / Output: / [TIME] / ---
+    static std::vector<DatabaseClass> parseText(const std::string& text);
+    // Parses a RecordWriter binary stream; a truncated last record is dropped
+    static std::vector<DatabaseClass> parseRecords(const std::string& data);
+    static bool isRecordStream(const std::string& data);
+    static void writeBinary(const std::vector<DatabaseClass>& classes, const std::string& filepath);
+    static void writeCompressed(const std::vector<DatabaseClass>& classes, const std::string& filepath,
+                                int block_classes = 64);
+
+private:
+    MIG decodePoint(const PointRecord& point) const;
+    bool findCompressed(uint64_t key, DatabaseClass& result) const;
+    void release();
+
+    const char* data = nullptr;
+    size_t length = 0;
+    std::vector<char> buffer;       // file contents where mmap is unavailable
+    const Header* header = nullptr;
+    const ClassRecord* class_records = nullptr;
+    const PointRecord* point_records = nullptr;
+    const NodeRecord* node_records = nullptr;
+    const BlockIndex* block_index = nullptr;
+    const uint8_t* payload = nullptr;
+    int n_vars = 0;
+    size_t num_classes = 0;
+};
+
+#endif // NPN_DATABASE_H
@@ -0,0 +1,157 @@
+#ifndef NPN_KERNELS_H
+#define NPN_KERNELS_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// Exact NPN canonization specialized per input count at compile time.
+//
+// Canonizer<N> walks all N! * 2^N * 2 transforms of a packed table (bit i =
+// row i) in a fixed order where each step is one operation on the word:
+// input permutations follow the Steinhaus-Johnson-Trotter sequence of
+// adjacent swaps, and between two swaps the input negations follow a Gray
+// code of single flips, fully unrolled. Output negation is checked at every
+// step. The swap and flip sequences are constexpr tables, and every mask and
+// shift is a constant of the instantiation.
+//
+// Transforms act on row-index bit positions directly (position p is
+// variable n - 1 - p), since every position is visited anyway.
+namespace npn_kernels {
+
+// Smallest unsigned type holding a 2^N-bit table
+template <int N>
+using Word = std::conditional_t<(N <= 3), uint8_t,
+             std::conditional_t<(N == 4), uint16_t,
+             std::conditional_t<(N == 5), uint32_t, uint64_t>>>;
+
+// Rows whose row-index bit p is set
+constexpr uint64_t kRowBitMasks[6] = {
+    0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+    0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL};
+
+constexpr size_t factorial(int n) { return n <= 1 ? 1 : n * factorial(n - 1); }
+
+// Steinhaus-Johnson-Trotter: N! - 1 adjacent swaps (entry p exchanges
+// positions p and p + 1) that together visit every order of N positions
+template <int N>
+constexpr std::array<uint8_t, factorial(N) - 1> swapSequence() {
+    std::array<uint8_t, factorial(N) - 1> swaps{};
+    std::array<int, (N > 0 ? N : 1)> order{}, direction{};
+    for (int i = 0; i < N; ++i) {
+        order[i] = i;
+        direction[i] = -1;
+    }
+    for (size_t step = 0; step < swaps.size(); ++step) {
+        // Largest element whose neighbour in its direction is smaller
+        int mobile = -1;
+        for (int i = 0; i < N; ++i) {
+            int j = i + direction[order[i]];
+            if (j >= 0 && j < N && order[j] < order[i] && (mobile < 0 || order[i] > order[mobile])) {
+                mobile = i;
+            }
+        }
+        int value = order[mobile];
+        int j = mobile + direction[value];
+        swaps[step] = static_cast<uint8_t>(std::min(mobile, j));
+        order[mobile] = order[j];
+        order[j] = value;
+        for (int k = 0; k < N; ++k) {
+            if (k > value) direction[k] = -direction[k];
+        }
+    }
+    return swaps;
+}
+
+// Gray code over the 2^N negation masks: step j flips position ctz(j + 1)
+template <int N>
+constexpr std::array<uint8_t, (size_t(1) << N) - 1> flipSequence() {
+    std::array<uint8_t, (size_t(1) << N) - 1> flips{};
+    for (size_t j = 0; j < flips.size(); ++j) {
+        uint8_t p = 0;
+        while (!(((j + 1) >> p) & 1)) p++;
+        flips[j] = p;
+    }
+    return flips;
+}
+
+template <int N>
+struct Canonizer {
+    static_assert(N >= 0 && N <= 6, "Canonizer supports 0 to 6 inputs");
+    using W = Word<N>;
+
+    static constexpr W kMask = static_cast<W>(N == 6 ? ~0ULL : (1ULL << (1 << N)) - 1);
+    static constexpr auto kSwaps = swapSequence<N>();
+    static constexpr auto kFlips = flipSequence<N>();
+
+    // Negates the input at row-index position P
+    template <int P>
+    static W flip(W t) {
+        constexpr W m = static_cast<W>(kRowBitMasks[P]);
+        constexpr int s = 1 << P;
+        return static_cast<W>((((t & m) >> s) | ((t << s) & m)) & kMask);
+    }
+
+    // Exchanges the inputs at row-index positions p and p + 1
+    static W swapAdjacent(W t, int p) {
+        W m = static_cast<W>(kRowBitMasks[p] & ~kRowBitMasks[p + 1]);
+        int s = 1 << p;
+        W d = static_cast<W>(((t >> s) ^ t) & m);
+        return static_cast<W>(t ^ d ^ (d << s));
+    }
+
+    static W smaller(W best, W t) {
+        return std::min({best, t, static_cast<W>(~t & kMask)});
+    }
+
+    template <size_t... I>
+    static void negations(W& t, W& best, std::index_sequence<I...>) {
+        ((t = flip<kFlips[I]>(t), best = smaller(best, t)), ...);
+    }
+
+    // Negating every input reverses the row order
+    template <size_t... P>
+    static W reverseRows(W t, std::index_sequence<P...>) {
+        ((t = flip<P>(t)), ...);
+        return t;
+    }
+
+    // Smallest packed table of the class
+    static W minimum(W tt) {
+        W t = static_cast<W>(tt & kMask);
+        W best = smaller(t, t);
+        for (size_t i = 0;; ++i) {
+            negations(t, best, std::make_index_sequence<kFlips.size()>());
+            if (i == kSwaps.size()) break;
+            t = swapAdjacent(t, kSwaps[i]);
+            best = smaller(best, t);
+        }
+        return best;
+    }
+
+    // Packed representative, bit i = row i of the lexicographically smallest
+    // truth table string of the class. A string compares like the number
+    // with row 0 as its most significant bit, i.e. the row-reversed packed
+    // table, and reversal is itself an NPN transform; so the smallest string
+    // is the reversal of the smallest packed table.
+    static W representative(W tt) {
+        return reversed(minimum(tt));
+    }
+
+    static W reversed(W t) {
+        return reverseRows(t, std::make_index_sequence<N>());
+    }
+
+    static void batch(const uint64_t* tables, uint64_t* representatives, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            representatives[i] = representative(static_cast<W>(tables[i]));
+        }
+    }
+};
+
+} // namespace npn_kernels
+
+#endif // NPN_KERNELS_H
@@ -0,0 +1,177 @@
+#include "npn_matcher.h"
+#include "npn_classifier.h"
+#include "npn_kernels.h"
+#include "profiler.h"
+#include "truth_table.h"
+#include <stdexcept>
+#include <utility>
+
+std::string NPNTransform::apply(const std::string& tt) const {
+    return NPNClassifier::applyNegationPattern(NPNClassifier::applyPermutation(tt, perm), neg_inputs, neg_output);
+}
+
+namespace {
+
+using npn_kernels::kRowBitMasks;
+
+// Rows whose row-index bit p is clear; also the SWAR masks that add
+// neighbouring 2^p-bit fields
+constexpr uint64_t kLowMasks[6] = {
+    0x5555555555555555ULL, 0x3333333333333333ULL, 0x0F0F0F0F0F0F0F0FULL,
+    0x00FF00FF00FF00FFULL, 0x0000FFFF0000FFFFULL, 0x00000000FFFFFFFFULL};
+
+// Onset size of every block of 2^Q consecutive rows, one count per block
+template <int Q>
+uint64_t blockCounts(uint64_t t) {
+    if constexpr (Q > 0) {
+        t = blockCounts<Q - 1>(t);
+        t = (t & kLowMasks[Q - 1]) + ((t >> (1 << (Q - 1))) & kLowMasks[Q - 1]);
+    }
+    return t;
+}
+
+// Exchanges row-index positions a < b
+uint64_t swapPositions(uint64_t t, int a, int b) {
+    uint64_t m = kRowBitMasks[a] & ~kRowBitMasks[b];
+    int s = (1 << b) - (1 << a);
+    uint64_t d = (t ^ (t >> s)) & m;
+    return t ^ d ^ (d << s);
+}
+
+uint64_t flipPosition(uint64_t t, int p) {
+    int s = 1 << p;
+    return ((t & kRowBitMasks[p]) >> s) | ((t << s) & kRowBitMasks[p]);
+}
+
+// Depth-first search for an input mapping of f (output phase applied) onto
+// g. Input k of g sits at row-index position q = n - 1 - k, so mapping g's
+// inputs in order fills positions from the top: at depth k the chosen input
+// of f is moved to position q and, if negated, flipped there. The unmapped
+// inputs then occupy positions below q, and the cofactor blocks over the
+// mapped ones are runs of 2^q rows whose onsets SWAR adds up in place.
+template <int N>
+class Search {
+public:
+    Search(uint64_t f, uint64_t g) : f(f) {
+        int total = TruthTable::countOnesPacked(g);
+        int f_cofactors[N + 1];
+        for (int j = 0; j < N; ++j) f_cofactors[j] = TruthTable::countOnesPacked(f & kRowBitMasks[N - 1 - j]);
+        countBlocks(g, std::make_index_sequence<N>());
+        for (int k = 0; k < N; ++k) {
+            int q = N - 1 - k;
+            position[k] = q;
+            var_at[q] = k;
+            // Input j of f may become input k of g with phase p (code 2j + p)
+            // only if the onsets of the matching cofactors have equal size
+            int d = TruthTable::countOnesPacked(g & kRowBitMasks[q]);
+            candidates[k] = 0;
+            for (int j = 0; j < N; ++j) {
+                if (f_cofactors[j] == d) candidates[k] |= 1u << (2 * j);
+                if (f_cofactors[j] == total - d) candidates[k] |= 1u << (2 * j + 1);
+            }
+        }
+    }
+
+    bool run(NPNTransform& transform) {
+        for (int k = 0; k < N; ++k) {
+            if (!candidates[k]) return false;
+        }
+        if (!extend<0>(f, (1u << (2 * N)) - 1)) return false;
+        transform.perm.assign(N, 0);
+        transform.neg_inputs.assign(N, 0);
+        for (int k = 0; k < N; ++k) {
+            transform.perm[image[k] >> 1] = k;
+            transform.neg_inputs[k] = image[k] & 1;
+        }
+        return true;
+    }
+
+private:
+    template <size_t... K>
+    void countBlocks([[maybe_unused]] uint64_t g, std::index_sequence<K...>) {
+        ((g_counts[K] = blockCounts<N - 1 - static_cast<int>(K)>(g)), ...);
+    }
+
+    // Inputs 0 .. K - 1 of g are mapped, t is f moved accordingly and
+    // free_codes holds the codes of the inputs of f still unmapped
+    template <int K>
+    bool extend(uint64_t t, uint32_t free_codes) {
+        if constexpr (K == N) {
+            return true;
+        } else {
+            constexpr int q = N - 1 - K;
+            for (uint32_t codes = candidates[K] & free_codes; codes; codes &= codes - 1) {
+                int code = __builtin_ctz(codes);
+                int j = code >> 1;
+                // Bring input j of f to position q; the unmapped input there
+                // takes j's old place
+                int from = position[j];
+                uint64_t moved = from == q ? t : swapPositions(t, from, q);
+                if (code & 1) moved = flipPosition(moved, q);
+                if (blockCounts<q>(moved) != g_counts[K]) continue;
+                int displaced = var_at[q];
+                position[displaced] = from;
+                var_at[from] = displaced;
+                position[j] = q;
+                var_at[q] = j;
+                image[K] = code;
+                if (extend<K + 1>(moved, free_codes & ~(3u << (2 * j)))) return true;
+                position[j] = from;
+                var_at[from] = j;
+                position[displaced] = q;
+                var_at[q] = displaced;
+            }
+            return false;
+        }
+    }
+
+    uint64_t f;
+    uint64_t g_counts[N + 1];   // blockCounts of g at each depth
+    uint32_t candidates[N + 1]; // per input of g, codes 2j + p
+    int position[N + 1];        // current position of each input of f
+    int var_at[N + 1];          // input of f at each position
+    int image[N + 1];           // code chosen for each input of g
+};
+
+template <int N>
+bool matchInputs(uint64_t f, uint64_t g, NPNTransform& transform) {
+    constexpr int kRows = 1 << N;
+    constexpr uint64_t kMask = N == 6 ? ~0ULL : (1ULL << kRows) - 1;
+    f &= kMask;
+    g &= kMask;
+    int f_ones = TruthTable::countOnesPacked(f), g_ones = TruthTable::countOnesPacked(g);
+    for (int neg_output = 0; neg_output < 2; ++neg_output) {
+        if ((neg_output ? kRows - f_ones : f_ones) != g_ones) continue;
+        Search<N> search(neg_output ? f ^ kMask : f, g);
+        if (search.run(transform)) {
+            transform.neg_output = neg_output;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool NPNMatcher::match(uint64_t f, uint64_t g, int n_vars, NPNTransform& transform) {
+    MIG_PROFILE_COUNT("npn.matches", 1);
+    switch (n_vars) {
+    case 0: return matchInputs<0>(f, g, transform);
+    case 1: return matchInputs<1>(f, g, transform);
+    case 2: return matchInputs<2>(f, g, transform);
+    case 3: return matchInputs<3>(f, g, transform);
+    case 4: return matchInputs<4>(f, g, transform);
+    case 5: return matchInputs<5>(f, g, transform);
+    case 6: return matchInputs<6>(f, g, transform);
+    default: throw std::invalid_argument("NPN matching supports at most 6 variables");
+    }
+}
+
+bool NPNMatcher::match(const std::string& f, const std::string& g, NPNTransform& transform) {
+    if (f.length() != g.length()) return false;
+    if (!TruthTable::validateTruthTable(f) || !TruthTable::validateTruthTable(g) || f.length() > 64) {
+        throw std::invalid_argument("Invalid truth table");
+    }
+    int n_vars = __builtin_ctzll(f.length());
+    return match(TruthTable::truthTableToBinary(f), TruthTable::truthTableToBinary(g), n_vars, transform);
+}
@@ -0,0 +1,42 @@
+#ifndef NPN_MATCHER_H
+#define NPN_MATCHER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// An NPN transform in the terms of NPNClassifier: g is
+//   applyNegationPattern(applyPermutation(f, perm), neg_inputs, neg_output)
+// i.e. input j of f reads input perm[j] of g, negated if neg_inputs[perm[j]].
+struct NPNTransform {
+    std::vector<int> perm;
+    std::vector<int> neg_inputs;
+    int neg_output = 0;
+
+    std::string apply(const std::string& tt) const;
+};
+
+// Pairwise Boolean matching: decides whether g is an NPN transform of f by
+// searching for the transform directly instead of canonizing both sides.
+//
+// The output phase is fixed by onset counts (both are tried when the table
+// is balanced). The inputs of g are then matched one at a time, each to an
+// unused input of f and a phase whose cofactor onset counts agree. Every
+// matched input halves the cofactor blocks of both functions, and a branch
+// is dropped as soon as two corresponding blocks differ in onset count;
+// once all inputs are matched the blocks are single rows, so reaching the
+// bottom proves the match. Random equivalent pairs need few backtracks, so
+// a match costs about one 4-input canonization and a small fraction of one
+// for 5 and 6 inputs; most inequivalent pairs fail on the counts alone.
+class NPNMatcher {
+public:
+    // Packed tables (bit i = row i) of up to 6 inputs; on success fills the
+    // witness transform
+    static bool match(uint64_t f, uint64_t g, int n_vars, NPNTransform& transform);
+
+    // Truth table strings of equal length; false if the lengths differ,
+    // std::invalid_argument if the tables are malformed or too wide
+    static bool match(const std::string& f, const std::string& g, NPNTransform& transform);
+};
+
+#endif // NPN_MATCHER_H
@@ -0,0 +1,125 @@
+#include "npn_shuffle.h"
+#include "npn_kernels.h"
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MIG_NPN_SHUFFLE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using Control = NPNShuffle::Control;
+
+constexpr bool nextPermutation(std::array<int, 4>& p) {
+    int i = 2;
+    while (i >= 0 && p[i] >= p[i + 1]) i--;
+    if (i < 0) return false;
+    int j = 3;
+    while (p[j] <= p[i]) j--;
+    int t = p[i]; p[i] = p[j]; p[j] = t;
+    for (int a = i + 1, b = 3; a < b; ++a, --b) {
+        t = p[a]; p[a] = p[b]; p[b] = t;
+    }
+    return true;
+}
+
+// Row r of the transformed table is row src(r) of the original, where src
+// permutes the row-index bits by perm and then complements those in neg
+constexpr std::array<Control, NPNShuffle::kInputTransforms> buildControls() {
+    std::array<Control, NPNShuffle::kInputTransforms> controls{};
+    std::array<int, 4> perm{0, 1, 2, 3};
+    size_t k = 0;
+    do {
+        for (int neg = 0; neg < 16; ++neg, ++k) {
+            for (int r = 0; r < 16; ++r) {
+                int src = 0;
+                for (int q = 0; q < 4; ++q) src |= (((r >> perm[q]) & 1) ^ ((neg >> q) & 1)) << q;
+                controls[k][r] = static_cast<uint8_t>(src);
+            }
+        }
+    } while (nextPermutation(perm));
+    return controls;
+}
+
+constexpr std::array<Control, NPNShuffle::kInputTransforms> kControls = buildControls();
+
+#ifdef MIG_NPN_SHUFFLE_X86
+
+#define MIG_NPN_SIMD __attribute__((target("ssse3,sse4.1")))
+
+// Transformed table as 16 bits: shuffle the row bytes, gather their top bits
+MIG_NPN_SIMD inline int applyControl(__m128i rows, const Control& control) {
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control.data()));
+    return _mm_movemask_epi8(_mm_shuffle_epi8(rows, c));
+}
+
+MIG_NPN_SIMD uint16_t minimumSIMD(uint16_t tt) {
+    // Byte r becomes 0xFF if row r is 1
+    const __m128i spread = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1);
+    const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+    __m128i rows = _mm_shuffle_epi8(_mm_cvtsi32_si128(tt), spread);
+    rows = _mm_cmpeq_epi8(_mm_and_si128(rows, bits), bits);
+
+    const __m128i all = _mm_set1_epi16(-1);
+    __m128i best = all;
+    for (int k = 0; k < NPNShuffle::kInputTransforms; k += 8) {
+        const Control* c = &kControls[k];
+        __m128i r = _mm_setr_epi16(
+            static_cast<short>(applyControl(rows, c[0])), static_cast<short>(applyControl(rows, c[1])),
+            static_cast<short>(applyControl(rows, c[2])), static_cast<short>(applyControl(rows, c[3])),
+            static_cast<short>(applyControl(rows, c[4])), static_cast<short>(applyControl(rows, c[5])),
+            static_cast<short>(applyControl(rows, c[6])), static_cast<short>(applyControl(rows, c[7])));
+        best = _mm_min_epu16(best, _mm_min_epu16(r, _mm_xor_si128(r, all)));
+    }
+    return static_cast<uint16_t>(_mm_extract_epi16(_mm_minpos_epu16(best), 0));
+}
+
+#endif
+
+} // namespace
+
+const std::array<Control, NPNShuffle::kInputTransforms>& NPNShuffle::controls() {
+    return kControls;
+}
+
+bool NPNShuffle::vectorized() {
+#ifdef MIG_NPN_SHUFFLE_X86
+    static const bool supported = __builtin_cpu_supports("ssse3") && __builtin_cpu_supports("sse4.1");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+uint16_t NPNShuffle::minimumScalar(uint16_t tt) {
+    uint16_t best = 0xFFFF;
+    for (const auto& control : kControls) {
+        uint16_t t = 0;
+        for (int r = 0; r < 16; ++r) t |= ((tt >> control[r]) & 1) << r;
+        best = std::min({best, t, static_cast<uint16_t>(~t)});
+    }
+    return best;
+}
+
+uint16_t NPNShuffle::minimum(uint16_t tt) {
+#ifdef MIG_NPN_SHUFFLE_X86
+    if (vectorized()) return minimumSIMD(tt);
+#endif
+    return minimumScalar(tt);
+}
+
+void NPNShuffle::batch(const uint64_t* tables, uint64_t* representatives, size_t count) {
+    using Kernel = npn_kernels::Canonizer<4>;
+#ifdef MIG_NPN_SHUFFLE_X86
+    if (vectorized()) {
+        for (size_t i = 0; i < count; ++i) {
+            representatives[i] = Kernel::reversed(minimumSIMD(static_cast<uint16_t>(tables[i])));
+        }
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; ++i) {
+        representatives[i] = Kernel::reversed(minimumScalar(static_cast<uint16_t>(tables[i])));
+    }
+}
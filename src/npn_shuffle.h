@@ -0,0 +1,40 @@
+#ifndef NPN_SHUFFLE_H
+#define NPN_SHUFFLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// NPN canonization of 4-input functions through byte shuffles.
+//
+// Input permutations and negations only move rows, so each of the 24 * 16
+// input transforms is one fixed permutation of the 16 rows, stored as a
+// PSHUFB control (byte r = source row of row r); the output phase doubles
+// them to 768. A table is spread to one byte per row, every control is
+// applied with PSHUFB and gathered back with PMOVMSKB, and the results,
+// with their complements, are reduced eight at a time with PMINUW and a
+// final PHMINPOSUW.
+//
+// The SIMD path is compiled for SSSE3/SSE4.1 regardless of the build flags
+// and selected at run time; elsewhere the same table drives a scalar
+// gather, so results never depend on the CPU.
+class NPNShuffle {
+public:
+    static constexpr int kInputTransforms = 384;
+    using Control = std::array<uint8_t, 16>;
+
+    static const std::array<Control, kInputTransforms>& controls();
+
+    // The CPU runs the SIMD path
+    static bool vectorized();
+
+    // Smallest packed table (bit i = row i) over all 768 transforms
+    static uint16_t minimum(uint16_t tt);
+    // Same as NPNClassifier::canonizeBatch for n_vars = 4
+    static void batch(const uint64_t* tables, uint64_t* representatives, size_t count);
+
+    // Scalar reference of minimum
+    static uint16_t minimumScalar(uint16_t tt);
+};
+
+#endif // NPN_SHUFFLE_H
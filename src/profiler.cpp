@@ -0,0 +1,280 @@
+#include "profiler.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+std::atomic<bool> profiling_enabled{true};
+
+// Totals of one region path, merged across threads
+struct MergedRegion {
+    uint64_t calls = 0;
+    uint64_t nanos = 0;
+    std::map<std::string, MergedRegion> children;
+};
+
+// Regions and counters are written only by their own thread. Readers walk
+// them under the thread's mutex, which the owner takes only to add entries,
+// and read the totals as relaxed atomics.
+struct Region {
+    std::string name;
+    std::vector<size_t> children;
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> nanos{0};
+};
+
+struct Counter {
+    std::string name;
+    std::atomic<uint64_t> value{0};
+};
+
+// Single writer, so a plain load and store suffice
+void add(std::atomic<uint64_t>& total, uint64_t delta) {
+    total.store(total.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+struct ThreadProfile;
+
+struct Registry {
+    std::mutex mutex;
+    std::set<ThreadProfile*> live;
+    MergedRegion retired;                       // threads that have exited
+    std::map<std::string, uint64_t> retired_counters;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+struct Frame {
+    size_t parent;
+    std::chrono::steady_clock::time_point start;
+};
+
+struct ThreadProfile {
+    std::mutex mutex;
+    std::deque<Region> regions;     // regions[0] is the root
+    std::deque<Counter> counters;
+    std::vector<Frame> stack;
+    size_t current = 0;
+
+    ThreadProfile();
+    ~ThreadProfile();
+};
+
+void mergeRegion(MergedRegion& into, const ThreadProfile& profile, size_t index) {
+    const Region& region = profile.regions[index];
+    into.calls += region.calls.load(std::memory_order_relaxed);
+    into.nanos += region.nanos.load(std::memory_order_relaxed);
+    for (size_t child : region.children) {
+        mergeRegion(into.children[profile.regions[child].name], profile, child);
+    }
+}
+
+void mergeCounters(std::map<std::string, uint64_t>& into, const ThreadProfile& profile) {
+    for (const auto& counter : profile.counters) {
+        into[counter.name] += counter.value.load(std::memory_order_relaxed);
+    }
+}
+
+ThreadProfile::ThreadProfile() {
+    regions.emplace_back();
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.live.insert(this);
+}
+
+ThreadProfile::~ThreadProfile() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    mergeRegion(reg.retired, *this, 0);
+    mergeCounters(reg.retired_counters, *this);
+    reg.live.erase(this);
+}
+
+ThreadProfile& localProfile() {
+    thread_local ThreadProfile profile;
+    return profile;
+}
+
+// Process totals: exited threads plus a snapshot of the running ones
+void collect(MergedRegion& root, std::map<std::string, uint64_t>& counters) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    root = reg.retired;
+    counters = reg.retired_counters;
+    for (ThreadProfile* profile : reg.live) {
+        std::lock_guard<std::mutex> profile_lock(profile->mutex);
+        mergeRegion(root, *profile, 0);
+        mergeCounters(counters, *profile);
+    }
+}
+
+uint64_t selfNanos(const MergedRegion& region) {
+    uint64_t children = 0;
+    for (const auto& [name, child] : region.children) children += child.nanos;
+    return region.nanos > children ? region.nanos - children : 0;
+}
+
+std::string jsonString(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+void writeRegions(std::ostringstream& out, const MergedRegion& parent, int indent) {
+    std::string pad(indent, ' ');
+    out << "[";
+    bool first = true;
+    for (const auto& [name, region] : parent.children) {
+        out << (first ? "\n" : ",\n") << pad << "  {\"name\": " << jsonString(name)
+            << ", \"calls\": " << region.calls << ", \"total_ms\": " << region.nanos / 1e6
+            << ", \"self_ms\": " << selfNanos(region) / 1e6 << ", \"children\": ";
+        writeRegions(out, region, indent + 2);
+        out << "}";
+        first = false;
+    }
+    out << (first ? "]" : "\n" + pad + "]");
+}
+
+void writeFolded(std::ostringstream& out, const MergedRegion& parent, const std::string& path) {
+    for (const auto& [name, region] : parent.children) {
+        std::string stack = path.empty() ? name : path + ";" + name;
+        uint64_t self_us = selfNanos(region) / 1000;
+        if (self_us > 0) out << stack << " " << self_us << "\n";
+        writeFolded(out, region, stack);
+    }
+}
+
+} // namespace
+
+void Profiler::setEnabled(bool enabled) {
+    profiling_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Profiler::enabled() {
+    return profiling_enabled.load(std::memory_order_relaxed);
+}
+
+void Profiler::enter(const char* name) {
+    ThreadProfile& profile = localProfile();
+    size_t parent = profile.current;
+    size_t child = 0;
+    for (size_t c : profile.regions[parent].children) {
+        if (profile.regions[c].name == name) {
+            child = c;
+            break;
+        }
+    }
+    if (child == 0) {
+        std::lock_guard<std::mutex> lock(profile.mutex);
+        child = profile.regions.size();
+        profile.regions.emplace_back();
+        profile.regions.back().name = name;
+        profile.regions[parent].children.push_back(child);
+    }
+    profile.stack.push_back({parent, std::chrono::steady_clock::now()});
+    profile.current = child;
+}
+
+void Profiler::leave() {
+    ThreadProfile& profile = localProfile();
+    if (profile.stack.empty()) return;
+    Frame frame = profile.stack.back();
+    profile.stack.pop_back();
+    Region& region = profile.regions[profile.current];
+    add(region.calls, 1);
+    add(region.nanos, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - frame.start).count());
+    profile.current = frame.parent;
+}
+
+void Profiler::count(const char* name, uint64_t delta) {
+    if (!enabled()) return;
+    ThreadProfile& profile = localProfile();
+    for (auto& counter : profile.counters) {
+        if (counter.name == name) {
+            add(counter.value, delta);
+            return;
+        }
+    }
+    std::lock_guard<std::mutex> lock(profile.mutex);
+    profile.counters.emplace_back();
+    profile.counters.back().name = name;
+    profile.counters.back().value.store(delta, std::memory_order_relaxed);
+}
+
+uint64_t Profiler::counter(const std::string& name) {
+    MergedRegion root;
+    std::map<std::string, uint64_t> counters;
+    collect(root, counters);
+    auto it = counters.find(name);
+    return it == counters.end() ? 0 : it->second;
+}
+
+std::string Profiler::toJson() {
+    MergedRegion root;
+    std::map<std::string, uint64_t> counters;
+    collect(root, counters);
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\n  \"regions\": ";
+    writeRegions(out, root, 2);
+    out << ",\n  \"counters\": {";
+    bool first = true;
+    for (const auto& [name, value] : counters) {
+        out << (first ? "\n" : ",\n") << "    " << jsonString(name) << ": " << value;
+        first = false;
+    }
+    out << (first ? "}" : "\n  }") << "\n}\n";
+    return out.str();
+}
+
+std::string Profiler::toFolded() {
+    MergedRegion root;
+    std::map<std::string, uint64_t> counters;
+    collect(root, counters);
+    std::ostringstream out;
+    writeFolded(out, root, "");
+    return out.str();
+}
+
+void Profiler::dump(const std::string& path) {
+    bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot write profile to " + path);
+    }
+    out << (json ? toJson() : toFolded());
+}
+
+void Profiler::reset() {
+    // Totals of running threads are zeroed in place; a region or counter
+    // updated concurrently may keep its value
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.retired = MergedRegion();
+    reg.retired_counters.clear();
+    for (ThreadProfile* profile : reg.live) {
+        std::lock_guard<std::mutex> profile_lock(profile->mutex);
+        for (auto& region : profile->regions) {
+            region.calls.store(0, std::memory_order_relaxed);
+            region.nanos.store(0, std::memory_order_relaxed);
+        }
+        for (auto& counter : profile->counters) counter.value.store(0, std::memory_order_relaxed);
+    }
+}
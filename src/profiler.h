@@ -0,0 +1,71 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+#include <string>
+
+// Scoped regions and counters cost a clock read and an uncontended atomic
+// update; builds that define MIG_NO_PROFILING compile them out entirely
+#define MIG_PROFILE_CONCAT_(a, b) a##b
+#define MIG_PROFILE_CONCAT(a, b) MIG_PROFILE_CONCAT_(a, b)
+#ifdef MIG_NO_PROFILING
+#define MIG_PROFILE_SCOPE(name) ((void)0)
+#define MIG_PROFILE_COUNT(name, delta) ((void)0)
+#else
+#define MIG_PROFILE_SCOPE(name) ProfileScope MIG_PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#define MIG_PROFILE_COUNT(name, delta) Profiler::count((name), (delta))
+#endif
+
+// Hierarchical wall-time profile with named counters.
+//
+// Every thread records into its own tree of nested regions (a region opened
+// inside another becomes its child) and its own counters, so recording never
+// contends with other threads. A thread's profile is folded into the process
+// totals when the thread exits; toJson/toFolded merge those totals with the
+// threads still running, matching regions by their path of names.
+class Profiler {
+public:
+    // Recording is on by default; while off, new scopes and count do nothing
+    static void setEnabled(bool enabled);
+    static bool enabled();
+
+    // Opens a region nested in this thread's current region; every enter
+    // must be matched by a leave on the same thread
+    static void enter(const char* name);
+    static void leave();
+
+    // Adds delta to a named counter, e.g. "db.hits"
+    static void count(const char* name, uint64_t delta = 1);
+
+    // Merged value of a counter
+    static uint64_t counter(const std::string& name);
+
+    // {"regions": [{"name", "calls", "total_ms", "self_ms", "children"}], "counters": {...}}
+    static std::string toJson();
+    // Folded stacks ("outer;inner <self microseconds>" per line), the input
+    // format of flamegraph.pl and speedscope
+    static std::string toFolded();
+    // Writes toJson to a .json path and toFolded to any other path
+    static void dump(const std::string& path);
+
+    // Clears every total and counter
+    static void reset();
+};
+
+// Region that lasts for the enclosing scope
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : active(Profiler::enabled()) {
+        if (active) Profiler::enter(name);
+    }
+    ~ProfileScope() {
+        if (active) Profiler::leave();
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    bool active;
+};
+
+#endif // PROFILER_H
@@ -0,0 +1,127 @@
+#include "progress_reporter.h"
+#include "utils.h"
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+std::string ProgressSnapshot::toLine() const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1) << "Progress: ";
+    if (total_functions > 0) out << 100.0 * functions / total_functions << "% ";
+    out << "functions (" << functions << "/" << total_functions << ", "
+        << std::setprecision(0) << functions_per_second << "/s), " << classes << " classes, "
+        << synthesized << " synthesized (" << std::setprecision(1) << classes_per_second
+        << "/s), queue " << queue_depth << ", ETA "
+        << (eta_seconds < 0 ? "unknown" : ProgressReporter::formatDuration(eta_seconds));
+    return out.str();
+}
+
+std::string ProgressSnapshot::toJson(const std::string& state) const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3) << "{\"state\": \"" << state << "\", \"functions\": "
+        << functions << ", \"total_functions\": " << total_functions << ", \"classes\": " << classes
+        << ", \"synthesized\": " << synthesized << ", \"queue_depth\": " << queue_depth
+        << ", \"elapsed_seconds\": " << elapsed_seconds << ", \"functions_per_second\": "
+        << functions_per_second << ", \"classes_per_second\": " << classes_per_second
+        << ", \"eta_seconds\": " << eta_seconds << "}\n";
+    return out.str();
+}
+
+ProgressReporter::ProgressReporter(const ProgressCounters& counters, uint64_t total_functions,
+                                   int interval_ms, const std::string& status_path,
+                                   std::function<size_t()> queue_depth)
+    : counters(counters), total_functions(total_functions), interval_ms(interval_ms),
+      status_path(status_path), queue_depth(std::move(queue_depth)),
+      start_time(std::chrono::steady_clock::now()) {}
+
+ProgressReporter::~ProgressReporter() {
+    halt();
+}
+
+void ProgressReporter::start() {
+    start_time = std::chrono::steady_clock::now();
+    start_synthesized = counters.synthesized.load(std::memory_order_relaxed);
+    if (interval_ms > 0) thread = std::thread(&ProgressReporter::loop, this);
+}
+
+void ProgressReporter::stop() {
+    halt();
+    writeStatus(sample(), "done");
+}
+
+void ProgressReporter::halt() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (thread.joinable()) thread.join();
+}
+
+ProgressSnapshot ProgressReporter::sample() const {
+    ProgressSnapshot s;
+    s.functions = counters.functions.load(std::memory_order_relaxed);
+    s.total_functions = total_functions;
+    s.classes = counters.classes.load(std::memory_order_relaxed);
+    s.synthesized = counters.synthesized.load(std::memory_order_relaxed);
+    s.queue_depth = queue_depth ? queue_depth() : 0;
+    s.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    if (s.elapsed_seconds <= 0) return s;
+
+    s.functions_per_second = s.functions / s.elapsed_seconds;
+    s.classes_per_second = (s.synthesized - std::min(s.synthesized, start_synthesized)) / s.elapsed_seconds;
+
+    uint64_t functions_left = counters.enumerated.load(std::memory_order_relaxed)
+                                  ? 0 : total_functions - std::min(total_functions, s.functions);
+    uint64_t backlog = s.classes - std::min(s.classes, s.synthesized);
+    if ((functions_left > 0 && s.functions_per_second <= 0) || (backlog > 0 && s.classes_per_second <= 0)) {
+        return s;
+    }
+    double enumeration = functions_left > 0 ? functions_left / s.functions_per_second : 0;
+    double synthesis = backlog > 0 ? backlog / s.classes_per_second : 0;
+    s.eta_seconds = std::max(enumeration, synthesis);
+    return s;
+}
+
+std::string ProgressReporter::formatDuration(double seconds) {
+    uint64_t total = static_cast<uint64_t>(seconds + 0.5);
+    uint64_t hours = total / 3600, minutes = total / 60 % 60, secs = total % 60;
+    std::ostringstream out;
+    out << std::setfill('0');
+    if (hours > 0) out << hours << "h" << std::setw(2) << minutes << "m";
+    else if (minutes > 0) out << minutes << "m" << std::setw(2) << secs << "s";
+    else out << secs << "s";
+    return out.str();
+}
+
+void ProgressReporter::loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!wake.wait_for(lock, std::chrono::milliseconds(interval_ms), [this]() { return stopping; })) {
+        lock.unlock();
+        ProgressSnapshot snapshot = sample();
+        Utils::logMessage(snapshot.toLine());
+        writeStatus(snapshot, "running");
+        lock.lock();
+    }
+}
+
+void ProgressReporter::writeStatus(const ProgressSnapshot& snapshot, const std::string& state) const {
+    if (status_path.empty()) return;
+    // Readers only ever see a complete file; no fsync, it is rewritten anyway
+    std::string tmp_path = status_path + ".tmp";
+    std::FILE* file = std::fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        Utils::logRateLimited("progress.status", "Cannot write status file " + status_path, 60000);
+        return;
+    }
+    std::string contents = snapshot.toJson(state);
+    bool ok = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    ok = (std::fclose(file) == 0) && ok;
+#ifdef _WIN32
+    std::remove(status_path.c_str());
+#endif
+    if (!ok || std::rename(tmp_path.c_str(), status_path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef PROGRESS_REPORTER_H
+#define PROGRESS_REPORTER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Totals published by the pipeline stages with relaxed stores; only the
+// reporter reads them
+struct ProgressCounters {
+    std::atomic<uint64_t> functions{0};     // enumerated by this run
+    std::atomic<uint64_t> classes{0};       // found so far
+    std::atomic<uint64_t> synthesized{0};   // classes written
+    std::atomic<bool> enumerated{false};    // no more classes will be found
+};
+
+struct ProgressSnapshot {
+    uint64_t functions = 0;
+    uint64_t total_functions = 0;
+    uint64_t classes = 0;
+    uint64_t synthesized = 0;
+    size_t queue_depth = 0;
+    double elapsed_seconds = 0;
+    double functions_per_second = 0;
+    double classes_per_second = 0;          // synthesized by this run
+    double eta_seconds = -1;                // negative while unknown
+
+    // "Progress: 12.5% ..." log line
+    std::string toLine() const;
+    // One JSON object, state being "running" or "done"
+    std::string toJson(const std::string& state) const;
+};
+
+// Samples ProgressCounters from its own thread every interval_ms, logs rate
+// and ETA, and, if status_path is set, atomically replaces that file with the
+// latest snapshot as JSON for monitoring. The stages never do I/O for it.
+//
+// The ETA is the later of the enumeration's (functions left at this run's
+// average rate) and the synthesis backlog's (classes found but not yet
+// written, at the average synthesis rate); classes not found yet are
+// unknown, so it firms up as enumeration progresses.
+class ProgressReporter {
+public:
+    ProgressReporter(const ProgressCounters& counters, uint64_t total_functions, int interval_ms = 5000,
+                     const std::string& status_path = "", std::function<size_t()> queue_depth = {});
+    ~ProgressReporter();
+    ProgressReporter(const ProgressReporter&) = delete;
+    ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+    void start();
+    // Stops sampling and writes the final status ("done")
+    void stop();
+
+    ProgressSnapshot sample() const;
+
+    // "1h02m", "3m05s", "42s"
+    static std::string formatDuration(double seconds);
+
+private:
+    void halt();
+    void loop();
+    void writeStatus(const ProgressSnapshot& snapshot, const std::string& state) const;
+
+    const ProgressCounters& counters;
+    uint64_t total_functions;
+    int interval_ms;
+    std::string status_path;
+    std::function<size_t()> queue_depth;
+
+    std::chrono::steady_clock::time_point start_time;
+    uint64_t start_synthesized = 0;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
+
+#endif // PROGRESS_REPORTER_H
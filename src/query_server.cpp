@@ -0,0 +1,401 @@
+#include "query_server.h"
+#include "decomposition.h"
+#include "npn_classifier.h"
+#include "profiler.h"
+#include "truth_table.h"
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t kReadSize = 1 << 16;
+constexpr size_t kWriteSize = 1 << 16;
+constexpr size_t kBinaryRequestSize = 9;
+
+enum class Mode { Unknown, Text, Binary };
+
+// Moves every complete request out of pending. At end of file a final line
+// without a newline counts as complete.
+void splitRequests(std::string& pending, Mode& mode, bool eof, std::vector<std::string>& requests) {
+    if (pending.empty()) return;
+    if (mode == Mode::Unknown) {
+        mode = (pending[0] == '0' || pending[0] == '1') ? Mode::Text : Mode::Binary;
+    }
+
+    size_t consumed = 0;
+    if (mode == Mode::Text) {
+        size_t newline;
+        while ((newline = pending.find('\n', consumed)) != std::string::npos) {
+            std::string line = pending.substr(consumed, newline - consumed);
+            consumed = newline + 1;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (!line.empty()) requests.push_back(line);
+        }
+        if (eof && consumed < pending.size()) {
+            requests.push_back(pending.substr(consumed));
+            consumed = pending.size();
+        }
+    } else {
+        for (; consumed + kBinaryRequestSize <= pending.size(); consumed += kBinaryRequestSize) {
+            requests.push_back(pending.substr(consumed, kBinaryRequestSize));
+        }
+    }
+    pending.erase(0, consumed);
+}
+
+bool writeAll(int fd, const std::string& data) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t n = write(fd, data.data() + written, data.size() - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+QueryServer::QueryServer(int num_threads, const std::string& data_dir, int timeout_ms)
+    : data_dir(data_dir), pool(num_threads), cache(data_dir + "/synthesis_cache.log", timeout_ms) {
+    // A client hanging up must not kill the server
+    std::signal(SIGPIPE, SIG_IGN);
+}
+
+QueryServer::~QueryServer() {
+    stop();
+}
+
+const NPNDatabase* QueryServer::database(int n_vars) {
+    std::lock_guard<std::mutex> lock(db_mutex);
+    if (!db_opened[n_vars]) {
+        db_opened[n_vars] = true;
+        try {
+            databases[n_vars] = std::make_unique<NPNDatabase>(
+                data_dir + "/npn_" + std::to_string(n_vars) + "var.db");
+        } catch (const std::runtime_error&) {
+            // No database for this size; every query synthesizes
+        }
+    }
+    return databases[n_vars].get();
+}
+
+QueryServer::Result QueryServer::resolve(const std::string& request) {
+    Result result;
+    std::string truth_table = request;
+    if (request.size() > 2 && request[1] == 'x') {
+        try {
+            truth_table = TruthTable::hexToTruthTable(request);
+        } catch (const std::invalid_argument&) {
+            truth_table.clear();
+        }
+    }
+    if (!TruthTable::validateTruthTable(truth_table) || truth_table.size() > 64) {
+        result.status = Error;
+        result.error = "invalid truth table";
+        return result;
+    }
+    int n_vars = TruthTable::getNumVars(truth_table);
+    result.representative = NPNClassifier::getNPNRepresentative(truth_table);
+
+    DatabaseClass cls;
+    const NPNDatabase* db = database(n_vars);
+    MIG_PROFILE_COUNT("db.lookups", 1);
+    if (db && db->find(result.representative, cls) && !cls.points.empty()) {
+        MIG_PROFILE_COUNT("db.hits", 1);
+        result.status = Database;
+        result.mig = cls.points[0];
+        return result;
+    }
+
+    std::unique_ptr<MIG> mig;
+    if (n_vars > 4) {
+        mig = Decomposer::synthesize(result.representative, [this](const std::string& block) {
+            return cache.getOrSynthesize(block);
+        });
+    } else {
+        mig = cache.getOrSynthesize(result.representative);
+    }
+    if (mig) {
+        result.status = Synthesized;
+        result.mig = *mig;
+    }
+    return result;
+}
+
+std::string QueryServer::answer(const std::string& truth_table) {
+    Result result = resolve(truth_table);
+    std::stringstream ss;
+    ss << truth_table << " ";
+    if (result.status == Error) {
+        ss << "ERROR " << result.error;
+    } else if (result.status == None) {
+        ss << result.representative << " NONE";
+    } else {
+        ss << result.representative << " " << (result.status == Database ? "db" : "synth") << " "
+           << result.mig.size() << " " << result.mig.depth() << " " << result.mig.toCompact();
+    }
+    return ss.str();
+}
+
+std::string QueryServer::answerBinary(const char* request) {
+    uint8_t n_vars = static_cast<uint8_t>(request[0]);
+    uint64_t packed = 0;
+    std::memcpy(&packed, request + 1, sizeof(packed));
+
+    BinaryAnswer answer{};
+    Result result;
+    if (n_vars > 6) {
+        result.status = Error;
+    } else {
+        result = resolve(TruthTable::binaryToTruthTable(packed, n_vars));
+    }
+    answer.status = result.status;
+
+    std::string encoded(sizeof(BinaryAnswer), '\0');
+    if (result.status == Database || result.status == Synthesized) {
+        answer.representative = TruthTable::truthTableToBinary(result.representative);
+        answer.num_gates = static_cast<uint8_t>(result.mig.size());
+        answer.depth = static_cast<uint8_t>(result.mig.depth());
+        answer.output = static_cast<uint8_t>(result.mig.outputs[0]);
+        answer.output_polarity = static_cast<uint8_t>(result.mig.output_polarities[0]);
+        for (const auto& g : result.mig.getGates()) {
+            NPNDatabase::NodeRecord node{};
+            for (int i = 0; i < 3; ++i) {
+                node.fanin[i] = static_cast<uint8_t>(g.inputs[i]);
+                node.polarities |= static_cast<uint8_t>(g.polarities[i] << i);
+            }
+            encoded.append(reinterpret_cast<const char*>(&node), sizeof(node));
+        }
+    } else if (result.status == None) {
+        answer.representative = TruthTable::truthTableToBinary(result.representative);
+    }
+    std::memcpy(&encoded[0], &answer, sizeof(answer));
+    return encoded;
+}
+
+std::string QueryServer::answerRequest(const std::string& request, bool binary) {
+    return binary ? answerBinary(request.data()) : answer(request) + "\n";
+}
+
+void QueryServer::serveStream(int in_fd, int out_fd) {
+    Mode mode = Mode::Unknown;
+    std::string pending;
+    char buffer[kReadSize];
+    bool eof = false;
+
+    while (!eof) {
+        ssize_t n = read(in_fd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            eof = true;
+        } else {
+            pending.append(buffer, static_cast<size_t>(n));
+        }
+
+        // Every complete request buffered so far forms one batch
+        std::vector<std::string> requests;
+        splitRequests(pending, mode, eof, requests);
+        if (requests.empty()) continue;
+
+        std::vector<std::string> answers(requests.size());
+        pool.parallelFor(requests.size(), [&](size_t i) {
+            answers[i] = answerRequest(requests[i], mode == Mode::Binary);
+        });
+
+        std::string batch;
+        for (const auto& a : answers) batch += a;
+        if (!writeAll(out_fd, batch)) return;
+    }
+}
+
+bool QueryServer::serveBatch(int in_fd, int out_fd, size_t window) {
+    // Answers land in a ring of window slots indexed by request number; the
+    // writer drains the ring in order and the reader stalls while it is full.
+    struct Slot {
+        std::string answer;
+        bool ready = false;
+    };
+    std::vector<Slot> slots(std::max<size_t>(window, 1));
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t submitted = 0;
+    size_t written = 0;
+    bool input_done = false;
+    bool write_failed = false;
+
+    std::thread writer([&]() {
+        std::string block;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            changed.wait(lock, [&]() {
+                return slots[written % slots.size()].ready || (input_done && written == submitted);
+            });
+            if (!slots[written % slots.size()].ready) break;
+            while (slots[written % slots.size()].ready && block.size() < kWriteSize) {
+                Slot& slot = slots[written % slots.size()];
+                block += slot.answer;
+                slot.answer.clear();
+                slot.ready = false;
+                written++;
+            }
+            changed.notify_all();
+
+            // Write in large blocks unless the pipeline has run dry
+            if (block.size() >= kWriteSize || !slots[written % slots.size()].ready) {
+                lock.unlock();
+                bool ok = writeAll(out_fd, block);
+                block.clear();
+                lock.lock();
+                if (!ok) {
+                    write_failed = true;
+                    changed.notify_all();
+                    return;
+                }
+            }
+        }
+        if (!block.empty()) write_failed = !writeAll(out_fd, block);
+    });
+
+    Mode mode = Mode::Unknown;
+    std::string pending;
+    char buffer[kReadSize];
+    bool eof = false;
+    while (!eof) {
+        ssize_t n = read(in_fd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            eof = true;
+        } else {
+            pending.append(buffer, static_cast<size_t>(n));
+        }
+
+        std::vector<std::string> requests;
+        splitRequests(pending, mode, eof, requests);
+        bool binary = mode == Mode::Binary;
+        for (auto& request : requests) {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() { return write_failed || submitted - written < slots.size(); });
+                if (write_failed) {
+                    eof = true;
+                    break;
+                }
+                index = submitted++;
+            }
+            pool.submit([&, index, binary, request = std::move(request)]() {
+                std::string result = answerRequest(request, binary);
+                std::lock_guard<std::mutex> lock(mutex);
+                Slot& slot = slots[index % slots.size()];
+                slot.answer = std::move(result);
+                slot.ready = true;
+                changed.notify_all();
+            });
+        }
+    }
+
+    // The writer only stops once every submitted answer has been taken, or
+    // after a failed write, in which case the remaining tasks must still drain
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        input_done = true;
+        changed.notify_all();
+    }
+    writer.join();
+    std::unique_lock<std::mutex> lock(mutex);
+    while (write_failed && written < submitted) {
+        changed.wait(lock, [&]() { return slots[written % slots.size()].ready; });
+        slots[written % slots.size()].ready = false;
+        written++;
+    }
+    return !write_failed;
+}
+
+void QueryServer::serveSocket(const std::string& socket_path) {
+    sockaddr_un address{};
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Socket path too long: " + socket_path);
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        throw std::runtime_error("Cannot create socket: " + socket_path);
+    }
+    unlink(socket_path.c_str());
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listen_fd, SOMAXCONN) != 0) {
+        close(listen_fd);
+        listen_fd = -1;
+        throw std::runtime_error("Cannot listen on socket: " + socket_path);
+    }
+
+    running = true;
+    while (running) {
+        int client = accept(listen_fd, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        std::lock_guard<std::mutex> lock(clients_mutex);
+        reapClients();
+        client_fds.push_back(client);
+        client_threads.emplace_back([this, client]() {
+            serveStream(client, client);
+            // The fd number may be reused once closed, so stop() must not see it
+            {
+                std::lock_guard<std::mutex> lock(clients_mutex);
+                client_fds.erase(std::find(client_fds.begin(), client_fds.end(), client));
+                finished_clients.push_back(std::this_thread::get_id());
+            }
+            close(client);
+        });
+    }
+    unlink(socket_path.c_str());
+}
+
+void QueryServer::stop() {
+    running = false;
+    if (listen_fd >= 0) {
+        shutdown(listen_fd, SHUT_RDWR);
+        close(listen_fd);
+        listen_fd = -1;
+    }
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard<std::mutex> lock(clients_mutex);
+        for (int fd : client_fds) shutdown(fd, SHUT_RDWR);
+        client_fds.clear();
+        threads.swap(client_threads);
+    }
+    for (auto& t : threads) t.join();
+    std::lock_guard<std::mutex> lock(clients_mutex);
+    finished_clients.clear();
+}
+
+size_t QueryServer::numClientThreads() {
+    std::lock_guard<std::mutex> lock(clients_mutex);
+    return client_threads.size();
+}
+
+void QueryServer::reapClients() {
+    // A finished thread only has close() left, which needs no lock
+    for (auto id : finished_clients) {
+        auto it = std::find_if(client_threads.begin(), client_threads.end(),
+                               [id](const std::thread& t) { return t.get_id() == id; });
+        if (it == client_threads.end()) continue;
+        it->join();
+        client_threads.erase(it);
+    }
+    finished_clients.clear();
+}
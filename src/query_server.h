@@ -0,0 +1,98 @@
+#ifndef QUERY_SERVER_H
+#define QUERY_SERVER_H
+
+#include "mig_structure.h"
+#include "npn_database.h"
+#include "synthesis_cache.h"
+#include "thread_pool.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Long-running class query service: databases are opened once and shared by
+// every client.
+//
+// Text protocol, one truth table per line (0/1 string or 0x hex), one answer
+// line per request:
+//   <tt> <representative> <db|synth> <size> <depth> <MIG::toCompact()>
+//   <tt> <representative> NONE         synthesis timed out
+//   <tt> ERROR <message>
+// Binary protocol, chosen when a stream does not start with '0' or '1':
+// requests are uint8 n_vars + uint64 packed truth table (native byte order),
+// answers are a BinaryAnswer followed by num_gates NPNDatabase::NodeRecords.
+//
+// All requests already buffered on a stream are answered as one batch on the
+// thread pool, and the batch goes out in request order with a single write.
+class QueryServer {
+public:
+    enum Status : uint8_t { None = 0, Database = 1, Synthesized = 2, Error = 255 };
+
+    struct BinaryAnswer {
+        uint64_t representative;
+        uint8_t status;
+        uint8_t num_gates;
+        uint8_t depth;
+        uint8_t output;
+        uint8_t output_polarity;
+        uint8_t reserved[3];
+    };
+
+    explicit QueryServer(int num_threads = 0, const std::string& data_dir = "data",
+                         int timeout_ms = 60000);
+    ~QueryServer();
+
+    // Answer line for one text request, without the newline
+    std::string answer(const std::string& truth_table);
+
+    // Serves one stream until in_fd reaches end of file
+    void serveStream(int in_fd, int out_fd);
+
+    // Streams every request from in_fd through the pool without waiting for
+    // batches: answers leave in input order through a reorder ring of window
+    // slots, so memory stays bounded however long the input is. Returns false
+    // if writing the output failed.
+    bool serveBatch(int in_fd, int out_fd, size_t window = 1 << 14);
+
+    // Accepts clients on a Unix domain socket until stop() is called
+    void serveSocket(const std::string& socket_path);
+    void stop();
+    // Client threads not joined yet; finished ones are joined on the next accept
+    size_t numClientThreads();
+
+private:
+    struct Result {
+        Status status = None;
+        std::string representative;
+        MIG mig;
+        std::string error;
+    };
+
+    Result resolve(const std::string& request);
+    const NPNDatabase* database(int n_vars);
+    std::string answerBinary(const char* request);
+    std::string answerRequest(const std::string& request, bool binary);
+
+    std::string data_dir;
+    ThreadPool pool;
+    SynthesisCache cache;
+
+    std::mutex db_mutex;
+    std::unique_ptr<NPNDatabase> databases[7];
+    bool db_opened[7] = {};
+
+    std::atomic<bool> running{false};
+    int listen_fd = -1;
+    std::mutex clients_mutex;
+    std::vector<int> client_fds;            // open connections only
+    std::vector<std::thread> client_threads;
+    std::vector<std::thread::id> finished_clients;
+
+    // Joins the threads of finished clients; needs clients_mutex
+    void reapClients();
+};
+
+#endif // QUERY_SERVER_H
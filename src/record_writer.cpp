@@ -0,0 +1,144 @@
+#include "record_writer.h"
+#include "truth_table.h"
+#include "utils.h"
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <io.h>
+#define fsync _commit
+#define fileno _fileno
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kStreamMagic[8] = {'M', 'I', 'G', 'N', 'P', 'N', 'R', 'S'};
+constexpr uint32_t kStreamVersion = 1;
+
+template <typename T>
+void append(std::string& buffer, const T& value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // namespace
+
+RecordWriter::RecordWriter(const std::string& filepath, int n_vars, Format format,
+                           int sync_every, size_t block_size, int64_t resume_at)
+    : filepath(filepath), n_vars(n_vars), format(format), sync_every(sync_every),
+      block_size(block_size) {
+    size_t last_slash = filepath.find_last_of("/\\");
+    if (last_slash != std::string::npos) {
+        Utils::ensureDir(filepath.substr(0, last_slash));
+    }
+    if (resume_at >= 0) {
+        std::error_code error;
+        std::filesystem::resize_file(filepath, static_cast<uintmax_t>(resume_at), error);
+        if (error) {
+            throw std::runtime_error("Cannot resume record file: " + filepath);
+        }
+        file_bytes = static_cast<uint64_t>(resume_at);
+    }
+    file = std::fopen(filepath.c_str(), resume_at >= 0 ? "ab" : "wb");
+    if (!file) {
+        throw std::runtime_error("Cannot open file for writing: " + filepath);
+    }
+    // Blocks are assembled here, so stdio buffering would only copy them again
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    buffer.reserve(block_size + 4096);
+
+    if (format == Format::Binary && file_bytes == 0) {
+        StreamHeader header{};
+        std::memcpy(header.magic, kStreamMagic, sizeof(kStreamMagic));
+        header.version = kStreamVersion;
+        header.n_vars = static_cast<uint32_t>(n_vars);
+        append(buffer, header);
+    }
+}
+
+RecordWriter::~RecordWriter() {
+    try {
+        close();
+    } catch (const std::exception&) {
+        // Destructors must not throw; call close() to see write errors
+    }
+}
+
+void RecordWriter::write(const DatabaseClass& cls, double seconds) {
+    if (!file) {
+        throw std::runtime_error("Write to closed record file: " + filepath);
+    }
+    if (TruthTable::getNumVars(cls.representative) != n_vars) {
+        throw std::invalid_argument("Record does not match file width: " + cls.representative);
+    }
+
+    if (format == Format::Text) {
+        std::ostringstream record;
+        record << "CLASS " << cls.representative << "\n";
+        for (const auto& mig : cls.points) {
+            record << "POINT " << mig.size() << " " << mig.depth() << "\n";
+            record << mig.toText();
+        }
+        if (seconds >= 0) record << "TIME " << seconds << "\n";
+        record << "---\n";
+        buffer += record.str();
+    } else {
+        append(buffer, StreamClass{TruthTable::truthTableToBinary(cls.representative),
+                                   static_cast<float>(seconds),
+                                   static_cast<uint32_t>(cls.points.size())});
+        for (const auto& mig : cls.points) {
+            append(buffer, StreamPoint{static_cast<uint16_t>(mig.size()),
+                                       static_cast<uint8_t>(mig.outputs[0]),
+                                       static_cast<uint8_t>(mig.output_polarities[0])});
+            for (const auto& g : mig.getGates()) {
+                NPNDatabase::NodeRecord node{};
+                for (int i = 0; i < 3; ++i) {
+                    node.fanin[i] = static_cast<uint8_t>(g.inputs[i]);
+                    node.polarities |= static_cast<uint8_t>(g.polarities[i] << i);
+                }
+                append(buffer, node);
+            }
+        }
+    }
+
+    records++;
+    if (sync_every > 0 && records % sync_every == 0) {
+        flush(true);
+    } else if (buffer.size() >= block_size) {
+        writeBlock();
+    }
+}
+
+void RecordWriter::writeBlock() {
+    if (buffer.empty()) return;
+    if (std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+        throw std::runtime_error("Write failed: " + filepath);
+    }
+    file_bytes += buffer.size();
+    buffer.clear();
+}
+
+void RecordWriter::flush(bool sync) {
+    if (!file) return;
+    writeBlock();
+    if (sync && fsync(fileno(file)) != 0) {
+        throw std::runtime_error("fsync failed: " + filepath);
+    }
+}
+
+void RecordWriter::close() {
+    if (!file) return;
+    std::FILE* f = file;
+    try {
+        flush(sync_every > 0);
+    } catch (...) {
+        std::fclose(f);
+        file = nullptr;
+        throw;
+    }
+    std::fclose(f);
+    file = nullptr;
+}
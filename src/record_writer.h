@@ -0,0 +1,74 @@
+#ifndef RECORD_WRITER_H
+#define RECORD_WRITER_H
+
+#include "npn_database.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Appends class results to a database file as they are produced, so memory
+// does not grow with the number of classes and a crash keeps every record
+// written before it.
+//
+// Text records use the compute driver format read by NPNDatabase::parseText.
+// Binary records form a stream read by NPNDatabase::parseRecords:
+//   StreamHeader, then per class a StreamClass, and per point a StreamPoint
+//   followed by its NPNDatabase::NodeRecords.
+class RecordWriter {
+public:
+    enum class Format { Text, Binary };
+
+    struct StreamHeader {
+        char magic[8];          // "MIGNPNRS"
+        uint32_t version;
+        uint32_t n_vars;
+    };
+    struct StreamClass {
+        uint64_t representative;    // packed, bit i = tt[i]
+        float seconds;              // synthesis time, negative if unknown
+        uint32_t num_points;
+    };
+    struct StreamPoint {
+        uint16_t num_gates;
+        uint8_t output;
+        uint8_t output_polarity;
+    };
+
+    // Buffered output is written in blocks of block_size bytes. With
+    // sync_every > 0 the file is also flushed and fsync'ed after every
+    // sync_every records. With resume_at >= 0 an existing file is cut back to
+    // resume_at bytes (dropping anything written after the last checkpoint)
+    // and appended to instead of being replaced.
+    RecordWriter(const std::string& filepath, int n_vars, Format format = Format::Text,
+                 int sync_every = 0, size_t block_size = 1 << 20, int64_t resume_at = -1);
+    ~RecordWriter();
+    RecordWriter(const RecordWriter&) = delete;
+    RecordWriter& operator=(const RecordWriter&) = delete;
+
+    // seconds < 0 omits the synthesis time
+    void write(const DatabaseClass& cls, double seconds = -1);
+
+    // Writes out buffered records; sync also forces them to disk
+    void flush(bool sync = false);
+    void close();
+
+    size_t count() const { return records; }
+    // File length once everything written so far is flushed
+    uint64_t offset() const { return file_bytes + buffer.size(); }
+
+private:
+    void writeBlock();
+
+    std::FILE* file = nullptr;
+    std::string filepath;
+    int n_vars;
+    Format format;
+    int sync_every;
+    size_t block_size;
+    std::string buffer;
+    size_t records = 0;
+    uint64_t file_bytes = 0;
+};
+
+#endif // RECORD_WRITER_H
@@ -0,0 +1,112 @@
+#include "synthesis_cache.h"
+#include "mig_synthesizer.h"
+#include "truth_table.h"
+#include "utils.h"
+#include <sstream>
+#include <stdexcept>
+
+SynthesisCache::SynthesisCache(const std::string& log_path, int timeout_ms)
+    : log_path(log_path), timeout_ms(timeout_ms) {
+    size_t last_slash = log_path.find_last_of("/\\");
+    if (last_slash != std::string::npos) {
+        Utils::ensureDir(log_path.substr(0, last_slash));
+    }
+    replay();
+    log.open(log_path, std::ios::app);
+    if (!log.is_open()) {
+        throw std::runtime_error("Cannot open cache log: " + log_path);
+    }
+}
+
+SynthesisCache::Key SynthesisCache::makeKey(const std::string& representative) {
+    if (!TruthTable::validateTruthTable(representative) || representative.size() > 64) {
+        throw std::invalid_argument("Invalid representative: " + representative);
+    }
+    return {TruthTable::getNumVars(representative), TruthTable::truthTableToBinary(representative)};
+}
+
+void SynthesisCache::store(const Key& key, const Entry& entry) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end() && it->second.status == Status::Optimal &&
+        entry.status != Status::Optimal) {
+        return;
+    }
+    shard.entries[key] = entry;
+}
+
+void SynthesisCache::replay() {
+    std::ifstream file(log_path);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream in(line);
+        std::string rep, status;
+        Entry entry{Status::Timeout, 0, nullptr};
+        if (!(in >> rep >> status >> entry.budget_ms)) continue;
+        if (!TruthTable::validateTruthTable(rep) || rep.size() > 64) continue;
+
+        if (status == "OPTIMAL") {
+            auto mig = std::make_shared<MIG>();
+            if (!MIG::fromCompact(in, TruthTable::getNumVars(rep), *mig)) continue;
+            entry.status = Status::Optimal;
+            entry.mig = mig;
+        } else if (status != "TIMEOUT") {
+            continue;
+        }
+        store(makeKey(rep), entry);
+    }
+}
+
+void SynthesisCache::append(const std::string& representative, const Entry& entry) {
+    std::stringstream ss;
+    ss << representative << " "
+       << (entry.status == Status::Optimal ? "OPTIMAL" : "TIMEOUT") << " " << entry.budget_ms;
+    if (entry.mig) {
+        ss << " " << entry.mig->toCompact();
+    }
+    ss << "\n";
+
+    std::lock_guard<std::mutex> lock(log_mutex);
+    log << ss.str();
+    log.flush();
+}
+
+bool SynthesisCache::lookup(const std::string& representative, Entry& entry) const {
+    Key key = makeKey(representative);
+    const Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end()) return false;
+    entry = it->second;
+    return true;
+}
+
+std::unique_ptr<MIG> SynthesisCache::getOrSynthesize(const std::string& representative) {
+    Entry entry;
+    if (lookup(representative, entry) &&
+        (entry.status == Status::Optimal || entry.budget_ms >= timeout_ms)) {
+        hit_count++;
+        return entry.mig ? std::make_unique<MIG>(*entry.mig) : nullptr;
+    }
+
+    // Concurrent misses on one class may both synthesize; the results agree
+    miss_count++;
+    MIGSynthesizer synthesizer(timeout_ms);
+    synthesizer.setCandidateLimit(candidate_limit);
+    auto mig = synthesizer.synthesizeSizeOptimal(representative);
+    entry = Entry{mig ? Status::Optimal : Status::Timeout, timeout_ms,
+                  mig ? std::make_shared<MIG>(*mig) : nullptr};
+    store(makeKey(representative), entry);
+    append(representative, entry);
+    return mig;
+}
+
+size_t SynthesisCache::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.entries.size();
+    }
+    return total;
+}
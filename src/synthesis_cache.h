@@ -0,0 +1,81 @@
+#ifndef SYNTHESIS_CACHE_H
+#define SYNTHESIS_CACHE_H
+
+#include "mig_structure.h"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// Synthesis results keyed by packed NPN representative, kept in memory and in
+// an append-only log that is replayed on construction. Each log line is
+//   <representative> OPTIMAL <budget_ms> <gates> (<a> <b> <c> <pa> <pb> <pc>)* <out> <pol>
+//   <representative> TIMEOUT <budget_ms>
+// and later lines override earlier ones, except that an optimal entry is
+// never replaced by a timeout. A torn last line is skipped on replay.
+class SynthesisCache {
+public:
+    enum class Status { Optimal, Timeout };
+
+    struct Entry {
+        Status status;
+        int budget_ms;              // synthesis timeout the entry was produced with
+        std::shared_ptr<const MIG> mig;  // null for timeouts
+    };
+
+    explicit SynthesisCache(const std::string& log_path = "data/synthesis_cache.log",
+                            int timeout_ms = 60000);
+
+    // Cached MIG for the representative, synthesizing it on a miss. Timeout
+    // entries are retried when this cache has a larger budget than the one
+    // they were recorded with. Returns nullptr if synthesis times out.
+    std::unique_ptr<MIG> getOrSynthesize(const std::string& representative);
+
+    // Cached entry without synthesizing; false on a miss
+    bool lookup(const std::string& representative, Entry& entry) const;
+
+    // Caps each synthesis, see MIGSynthesizer::setCandidateLimit. Searches
+    // stopped by it are recorded as timeouts of this cache's budget.
+    void setCandidateLimit(uint64_t limit) { candidate_limit = limit; }
+
+    size_t size() const;
+    uint64_t hits() const { return hit_count; }
+    uint64_t misses() const { return miss_count; }
+
+private:
+    using Key = std::pair<int, uint64_t>;  // (n_vars, packed truth table)
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return std::hash<uint64_t>()(key.second * 0x9E3779B97F4A7C15ULL + key.first);
+        }
+    };
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<Key, Entry, KeyHash> entries;
+    };
+    static constexpr int kShards = 16;
+
+    static Key makeKey(const std::string& representative);
+    Shard& shardFor(const Key& key) { return shards[KeyHash()(key) % kShards]; }
+    const Shard& shardFor(const Key& key) const { return shards[KeyHash()(key) % kShards]; }
+
+    // Inserts unless it would downgrade an optimal entry
+    void store(const Key& key, const Entry& entry);
+    void replay();
+    void append(const std::string& representative, const Entry& entry);
+
+    std::string log_path;
+    int timeout_ms;
+    uint64_t candidate_limit = 0;
+    Shard shards[kShards];
+    std::mutex log_mutex;
+    std::ofstream log;
+    std::atomic<uint64_t> hit_count{0};
+    std::atomic<uint64_t> miss_count{0};
+};
+
+#endif // SYNTHESIS_CACHE_H
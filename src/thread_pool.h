@@ -0,0 +1,39 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads consuming a shared task queue
+class ThreadPool {
+public:
+    // 0 threads means one per hardware thread
+    explicit ThreadPool(int num_threads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Runs body(i) for every i in [0, count) on the pool and waits for all of
+    // them. Must not be called from a pool thread.
+    void parallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+};
+
+#endif // THREAD_POOL_H
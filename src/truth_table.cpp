@@ -1,21 +1,23 @@
 #include "truth_table.h"
+#include "npn_kernels.h"
 #include <cmath>
 #include <stdexcept>
 #include <algorithm>
 
 std::vector<std::string> TruthTable::generateAllTruthTables(int n_vars) {
-    int num_rows = 1 << n_vars;
-    int num_functions = 1 << num_rows;
+    if (n_vars > 4) {
+        throw std::invalid_argument("Too many functions to materialize; use TruthTableRange");
+    }
     std::vector<std::string> all_tables;
-    
-    for (int func = 0; func < num_functions; ++func) {
-        std::string tt;
-        for (int row = 0; row < num_rows; ++row) {
-            tt += ((func >> row) & 1) ? '1' : '0';
+    TruthTableRange range(n_vars);
+    all_tables.reserve(range.size());
+
+    std::vector<uint64_t> chunk;
+    while (range.nextChunk(chunk)) {
+        for (uint64_t func : chunk) {
+            all_tables.push_back(binaryToTruthTable(func, n_vars));
         }
-        all_tables.push_back(tt);
     }
-    
     return all_tables;
 }
 
@@ -42,6 +44,9 @@ int TruthTable::getNumVars(const std::string& tt) {
 }
 
 uint64_t TruthTable::truthTableToBinary(const std::string& tt) {
+    if (tt.length() > 64) {
+        throw std::invalid_argument("Truth table does not fit in 64 bits");
+    }
     uint64_t result = 0;
     for (size_t i = 0; i < tt.length(); ++i) {
         if (tt[i] == '1') {
@@ -62,6 +67,32 @@ std::string TruthTable::binaryToTruthTable(uint64_t binary, int n_vars) {
     return tt;
 }
 
+std::string TruthTable::hexToTruthTable(const std::string& hex) {
+    if (hex.size() < 3 || hex[0] != '0' || (hex[1] != 'x' && hex[1] != 'X')) {
+        throw std::invalid_argument("Hex truth table needs a 0x prefix: " + hex);
+    }
+    size_t digits = hex.size() - 2;
+    if (digits > 16 || (digits & (digits - 1)) != 0) {
+        throw std::invalid_argument("Hex truth table must have 1, 2, 4, 8 or 16 digits: " + hex);
+    }
+
+    uint64_t binary = 0;
+    for (size_t i = 2; i < hex.size(); ++i) {
+        char c = hex[i];
+        int value;
+        if (c >= '0' && c <= '9') value = c - '0';
+        else if (c >= 'a' && c <= 'f') value = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') value = c - 'A' + 10;
+        else throw std::invalid_argument("Invalid hex digit in truth table: " + hex);
+        binary = (binary << 4) | value;
+    }
+
+    // One digit covers four rows
+    int n_vars = 2;
+    while ((size_t(1) << n_vars) < 4 * digits) n_vars++;
+    return binaryToTruthTable(binary, n_vars);
+}
+
 std::string TruthTable::getCofactor(const std::string& tt, int var_index, int value) {
     int n_vars = getNumVars(tt);
     std::string cofactor;
@@ -104,3 +135,206 @@ bool TruthTable::validateTruthTable(const std::string& tt) {
     int length = tt.length();
     return (length > 0) && ((length & (length - 1)) == 0);
 }
+
+using npn_kernels::kRowBitMasks;
+
+uint64_t TruthTable::varMask(int n_vars, int var_index) {
+    // x1 is the most significant bit of the row index
+    uint64_t table_mask = (n_vars == 6) ? ~0ULL : ((1ULL << (1 << n_vars)) - 1);
+    return kRowBitMasks[n_vars - 1 - var_index] & table_mask;
+}
+
+uint64_t TruthTable::getCofactorPacked(uint64_t tt, int n_vars, int var_index, int value) {
+    uint64_t mask = varMask(n_vars, var_index);
+    int shift = 1 << (n_vars - 1 - var_index);
+    if (value) {
+        uint64_t high = tt & mask;
+        return high | (high >> shift);
+    }
+    uint64_t low = tt & (mask >> shift);
+    return low | (low << shift);
+}
+
+bool TruthTable::dependsOnVarPacked(uint64_t tt, int n_vars, int var_index) {
+    uint64_t mask = varMask(n_vars, var_index);
+    int shift = 1 << (n_vars - 1 - var_index);
+    return ((tt & mask) >> shift) != (tt & (mask >> shift));
+}
+
+TruthTableRange::TruthTableRange(int n_vars)
+    : TruthTableRange(n_vars, 0, (n_vars >= 0 && n_vars <= 5) ? (1ULL << (1 << n_vars)) : 0) {}
+
+TruthTableRange::TruthTableRange(int n_vars, uint64_t first, uint64_t last)
+    : n_vars(n_vars), first_value(first), last_value(last), next_value(first) {
+    if (n_vars < 0 || n_vars > 5) {
+        throw std::invalid_argument("TruthTableRange supports at most 5 variables");
+    }
+    if (first > last || last > (1ULL << (1 << n_vars))) {
+        throw std::invalid_argument("Truth table range out of bounds");
+    }
+}
+
+bool TruthTableRange::nextChunk(std::vector<uint64_t>& chunk, size_t max_size) {
+    chunk.clear();
+    uint64_t count = std::min<uint64_t>(max_size, last_value - next_value);
+    if (count == 0) return false;
+    chunk.resize(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        chunk[i] = next_value + i;
+    }
+    next_value += count;
+    return true;
+}
+
+std::vector<TruthTableRange> TruthTableRange::split(uint64_t parts) const {
+    if (parts == 0) {
+        throw std::invalid_argument("Cannot split a range into zero parts");
+    }
+    std::vector<TruthTableRange> ranges;
+    uint64_t base = size() / parts, extra = size() % parts;
+    uint64_t start = first_value;
+    for (uint64_t p = 0; p < parts; ++p) {
+        uint64_t length = base + (p < extra ? 1 : 0);
+        ranges.emplace_back(n_vars, start, start + length);
+        start += length;
+    }
+    return ranges;
+}
+
+WideTruthTable::WideTruthTable(int n_vars) : n_vars(n_vars) {
+    if (n_vars < 0 || n_vars > kMaxVars) {
+        throw std::invalid_argument("WideTruthTable supports at most 16 variables");
+    }
+    table.assign(n_vars <= 6 ? 1 : (size_t(1) << (n_vars - 6)), 0);
+}
+
+WideTruthTable WideTruthTable::fromString(const std::string& tt) {
+    if (!TruthTable::validateTruthTable(tt)) {
+        throw std::invalid_argument("Invalid truth table length");
+    }
+    int n = 0;
+    while ((size_t(1) << n) < tt.length()) n++;
+    WideTruthTable result(n);
+    for (size_t i = 0; i < tt.length(); ++i) {
+        if (tt[i] == '1') result.table[i >> 6] |= 1ULL << (i & 63);
+    }
+    return result;
+}
+
+std::string WideTruthTable::toString() const {
+    uint64_t rows = 1ULL << n_vars;
+    std::string tt(rows, '0');
+    for (uint64_t i = 0; i < rows; ++i) {
+        if (getBit(i)) tt[i] = '1';
+    }
+    return tt;
+}
+
+void WideTruthTable::setBit(uint64_t row, bool value) {
+    uint64_t bit = 1ULL << (row & 63);
+    if (value) table[row >> 6] |= bit;
+    else table[row >> 6] &= ~bit;
+}
+
+uint64_t WideTruthTable::validMask() const {
+    return n_vars >= 6 ? ~0ULL : ((1ULL << (1 << n_vars)) - 1);
+}
+
+uint64_t WideTruthTable::countOnes() const {
+    uint64_t count = 0;
+    for (uint64_t word : table) count += TruthTable::countOnesPacked(word);
+    return count;
+}
+
+uint64_t WideTruthTable::countOnesCofactor(int var_index, int value) const {
+    int bit = n_vars - 1 - var_index;
+    uint64_t count = 0;
+    if (bit < 6) {
+        uint64_t mask = (value ? kRowBitMasks[bit] : ~kRowBitMasks[bit]) & validMask();
+        for (uint64_t word : table) count += TruthTable::countOnesPacked(word & mask);
+    } else {
+        size_t stride = size_t(1) << (bit - 6);
+        for (size_t w = 0; w < table.size(); ++w) {
+            if (((w & stride) != 0) == (value != 0)) count += TruthTable::countOnesPacked(table[w]);
+        }
+    }
+    return count;
+}
+
+void WideTruthTable::complement() {
+    for (uint64_t& word : table) word = ~word;
+    table[0] &= validMask();
+}
+
+void WideTruthTable::flipVar(int var_index) {
+    int bit = n_vars - 1 - var_index;
+    if (bit < 6) {
+        uint64_t mask = kRowBitMasks[bit];
+        int shift = 1 << bit;
+        for (uint64_t& word : table) {
+            word = ((word & mask) >> shift) | ((word & ~mask) << shift);
+        }
+        table[0] &= validMask();
+        return;
+    }
+    size_t stride = size_t(1) << (bit - 6);
+    for (size_t w = 0; w < table.size(); ++w) {
+        if (!(w & stride)) std::swap(table[w], table[w | stride]);
+    }
+}
+
+void WideTruthTable::swapVars(int var1, int var2) {
+    // Rows with row-index bit low set and bit high clear trade places with
+    // the rows that have them the other way round
+    int low = n_vars - 1 - std::max(var1, var2);
+    int high = n_vars - 1 - std::min(var1, var2);
+    if (low == high) return;
+    if (high < 6) {
+        int shift = (1 << high) - (1 << low);
+        uint64_t mask = kRowBitMasks[low] & ~kRowBitMasks[high];
+        for (uint64_t& word : table) {
+            uint64_t delta = ((word >> shift) ^ word) & mask;
+            word ^= delta | (delta << shift);
+        }
+    } else if (low >= 6) {
+        size_t low_stride = size_t(1) << (low - 6), high_stride = size_t(1) << (high - 6);
+        for (size_t w = 0; w < table.size(); ++w) {
+            if ((w & low_stride) && !(w & high_stride)) {
+                std::swap(table[w], table[w - low_stride + high_stride]);
+            }
+        }
+    } else {
+        uint64_t mask = kRowBitMasks[low];
+        int shift = 1 << low;
+        size_t high_stride = size_t(1) << (high - 6);
+        for (size_t w = 0; w < table.size(); ++w) {
+            if (w & high_stride) continue;
+            uint64_t& lo = table[w];
+            uint64_t& hi = table[w | high_stride];
+            uint64_t to_hi = (lo & mask) >> shift;
+            uint64_t to_lo = (hi & ~mask) << shift;
+            lo = (lo & ~mask) | to_lo;
+            hi = (hi & mask) | to_hi;
+        }
+    }
+}
+
+uint64_t WideTruthTable::hash() const {
+    // splitmix64 finalizer over each word, chained
+    uint64_t h = 0x9E3779B97F4A7C15ULL * (n_vars + 1);
+    for (uint64_t word : table) {
+        uint64_t z = h ^ word;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        h = z ^ (z >> 31);
+    }
+    return h;
+}
+
+bool WideTruthTable::operator<(const WideTruthTable& other) const {
+    if (n_vars != other.n_vars) return n_vars < other.n_vars;
+    for (size_t w = table.size(); w-- > 0;) {
+        if (table[w] != other.table[w]) return table[w] < other.table[w];
+    }
+    return false;
+}
@@ -5,7 +5,8 @@
 
 class TruthTable {
 public:
-    // Generate all truth tables for n_vars variables
+    // Generate all truth tables for n_vars variables (at most 4; use
+    // TruthTableRange to enumerate larger spaces)
     static std::vector<std::string> generateAllTruthTables(int n_vars);
 
     // Evaluate the truth table with given inputs
@@ -14,12 +15,17 @@ public:
     // Number of variables in a truth table
     static int getNumVars(const std::string& tt);
 
-    // Convert truth table string to binary representation
+    // Convert truth table string to binary representation; throws
+    // std::invalid_argument past 64 rows (use WideTruthTable)
     static uint64_t truthTableToBinary(const std::string& tt);
 
     // Convert binary representation to truth table string
     static std::string binaryToTruthTable(uint64_t binary, int n_vars);
 
+    // Convert hex ("0x" prefix, most significant digit first, bit i = row i)
+    // to a truth table string; throws std::invalid_argument on bad input
+    static std::string hexToTruthTable(const std::string& hex);
+
     // Get cofactor with respect to variable
     static std::string getCofactor(const std::string& tt, int var_index, int value);
 
@@ -31,4 +37,104 @@ public:
 
     // Validate truth table
     static bool validateTruthTable(const std::string& tt);
+
+    // Packed (bit i = tt[i]) operations for up to 6 variables
+
+    // Packed truth table of variable var_index
+    static uint64_t varMask(int n_vars, int var_index);
+
+    // Cofactor with the variable fixed to value, kept at n_vars width
+    static uint64_t getCofactorPacked(uint64_t tt, int n_vars, int var_index, int value);
+
+    // Check if packed truth table depends on a variable
+    static bool dependsOnVarPacked(uint64_t tt, int n_vars, int var_index);
+
+    // Number of set bits. Plain SWAR, since without -mpopcnt the builtin
+    // (and std::bitset::count) is a library call.
+    static constexpr int countOnesPacked(uint64_t tt) {
+        tt -= (tt >> 1) & 0x5555555555555555ULL;
+        tt = (tt & 0x3333333333333333ULL) + ((tt >> 2) & 0x3333333333333333ULL);
+        tt = (tt + (tt >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return static_cast<int>((tt * 0x0101010101010101ULL) >> 56);
+    }
+};
+
+// Lazy range [first, last) of packed truth tables over n_vars inputs (at most
+// 5, so that 2^(2^n) still fits the 64-bit counters). Tables are produced a
+// chunk at a time, so enumerating the range needs constant memory.
+class TruthTableRange {
+public:
+    static constexpr size_t kDefaultChunk = 4096;  // 32 KiB, fits in L1
+
+    // Every function of n_vars inputs
+    explicit TruthTableRange(int n_vars);
+    TruthTableRange(int n_vars, uint64_t first, uint64_t last);
+
+    int numVars() const { return n_vars; }
+    uint64_t first() const { return first_value; }
+    uint64_t last() const { return last_value; }
+    uint64_t size() const { return last_value - first_value; }
+
+    // Next unconsumed table
+    uint64_t position() const { return next_value; }
+
+    // Replaces chunk with up to max_size consecutive tables; false once the
+    // range is exhausted
+    bool nextChunk(std::vector<uint64_t>& chunk, size_t max_size = kDefaultChunk);
+
+    // Splits the whole range into parts contiguous sub-ranges whose sizes
+    // differ by at most one, for independent consumers
+    std::vector<TruthTableRange> split(uint64_t parts) const;
+
+private:
+    int n_vars;
+    uint64_t first_value;
+    uint64_t last_value;
+    uint64_t next_value;
+};
+
+// Truth table of up to 16 inputs packed into 64-bit words, bit i of the table
+// (bit i % 64 of word i / 64) being row i. As for the string form, x1 is the
+// most significant bit of the row index. Every operation is linear in the
+// number of words.
+class WideTruthTable {
+public:
+    static constexpr int kMaxVars = 16;
+
+    // Constant zero over n_vars inputs
+    explicit WideTruthTable(int n_vars);
+
+    static WideTruthTable fromString(const std::string& tt);
+    std::string toString() const;
+
+    int numVars() const { return n_vars; }
+    const std::vector<uint64_t>& words() const { return table; }
+
+    bool getBit(uint64_t row) const { return (table[row >> 6] >> (row & 63)) & 1; }
+    void setBit(uint64_t row, bool value);
+
+    uint64_t countOnes() const;
+    // Ones of the cofactor with var_index fixed to value
+    uint64_t countOnesCofactor(int var_index, int value) const;
+
+    // Negates the output, negates an input, or exchanges two inputs in place
+    void complement();
+    void flipVar(int var_index);
+    void swapVars(int var1, int var2);
+
+    // 64-bit mix of n_vars and the words, for hash tables and database keys
+    uint64_t hash() const;
+
+    bool operator==(const WideTruthTable& other) const {
+        return n_vars == other.n_vars && table == other.table;
+    }
+    bool operator!=(const WideTruthTable& other) const { return !(*this == other); }
+    // Orders tables of the same width as numbers, row 2^n - 1 most significant
+    bool operator<(const WideTruthTable& other) const;
+
+private:
+    uint64_t validMask() const;
+
+    int n_vars;
+    std::vector<uint64_t> table;
 };
@@ -1,4 +1,5 @@
 #include "utils.h"
+#include "profiler.h"
 #include <fstream>
 #include <iostream>
 #include <iomanip>
@@ -64,33 +65,32 @@ std::string Utils::formatBinary(uint64_t value, int width) {
     return result;
 }
 
-void Utils::logMessage(const std::string& message, const std::string& logfile) {
-    // Extract directory path
-    size_t last_slash = logfile.find_last_of("/\\");
-    if (last_slash != std::string::npos) {
-        std::string dir = logfile.substr(0, last_slash);
-        ensureDir(dir);
-    }
-    
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    
-    std::ofstream log(logfile, std::ios::app);
-    if (log.is_open()) {
-        struct tm* timeinfo = std::localtime(&time_t);
-        log << "[" << std::put_time(timeinfo, "%Y-%m-%d %H:%M:%S") << "] " 
-            << message << std::endl;
-    }
-    
-    std::cout << message << std::endl;
+void Utils::logMessage(const std::string& message, const std::string& logfile, LogLevel level) {
+    Logger::instance().log(level, message, logfile);
+}
+
+bool Utils::logRateLimited(const std::string& key, const std::string& message, int interval_ms,
+                           const std::string& logfile) {
+    return Logger::instance().logRateLimited(key, message, interval_ms, logfile);
+}
+
+void Utils::setLogLevel(LogLevel level) {
+    Logger::instance().setLevel(level);
+}
+
+void Utils::flushLog() {
+    Logger::instance().flush();
 }
 
-Utils::Timer::Timer(const std::string& timer_name) : name(timer_name) {
+Utils::Timer::Timer(const std::string& timer_name)
+    : name(timer_name), profiled(Profiler::enabled()) {
+    if (profiled) Profiler::enter(name.c_str());
     start_time = std::chrono::high_resolution_clock::now();
 }
 
 Utils::Timer::~Timer() {
     double elapsed_time = elapsed();
+    if (profiled) Profiler::leave();
     std::cout << name << " took " << elapsed_time << " seconds" << std::endl;
 }
 
@@ -5,6 +5,7 @@
 #include <vector>
 #include <chrono>
 #include <cstdint>
+#include "logger.h"
 
 class Utils {
 public:
@@ -16,14 +17,23 @@ public:
     // Formatting
     static std::string formatBinary(uint64_t value, int width);
     
-    // Logging
-    static void logMessage(const std::string& message, const std::string& logfile = "logs/synthesis.log");
+    // Logging, written asynchronously by the Logger thread. Messages below the
+    // current level are dropped; debug messages go to the file only.
+    static void logMessage(const std::string& message, const std::string& logfile = "logs/synthesis.log",
+                           LogLevel level = LogLevel::Info);
+    // For per-class progress: at most one message per key every interval_ms
+    static bool logRateLimited(const std::string& key, const std::string& message, int interval_ms = 1000,
+                               const std::string& logfile = "logs/synthesis.log");
+    static void setLogLevel(LogLevel level);
+    // Waits until every message logged so far has been written
+    static void flushLog();
     
-    // Timer utility
+    // Timer utility; the timed scope is also a profiler region of that name
     class Timer {
     private:
         std::chrono::high_resolution_clock::time_point start_time;
         std::string name;
+        bool profiled;
     public:
         Timer(const std::string& timer_name);
         ~Timer();
@@ -0,0 +1,146 @@
+#include "walsh_spectrum.h"
+#include "truth_table.h"
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// Fixed-size butterflies over int16 lanes
+template <int N>
+void butterfliesScalar(uint64_t tt, int16_t* s) {
+    constexpr int kRows = 1 << N;
+    for (int x = 0; x < kRows; ++x) s[x] = static_cast<int16_t>(1 - 2 * static_cast<int>((tt >> x) & 1));
+    for (int h = 1; h < kRows; h <<= 1) {
+        for (int i = 0; i < kRows; i += 2 * h) {
+            for (int j = i; j < i + h; ++j) {
+                int16_t a = s[j], b = s[j + h];
+                s[j] = static_cast<int16_t>(a + b);
+                s[j + h] = static_cast<int16_t>(a - b);
+            }
+        }
+    }
+}
+
+#ifdef __SSE2__
+
+// Butterfly of span h < 8 inside each vector: with p the lanes swapped
+// across the span and m = -1 on the upper lane of every pair, lane j gets
+// p + v on the lower side (a + b) and p - v on the upper side (a - b)
+inline __m128i innerPass(__m128i v, __m128i p, __m128i m) {
+    return _mm_add_epi16(p, _mm_sub_epi16(_mm_xor_si128(v, m), m));
+}
+
+// Eight rows per vector; SSE2 is part of every x86-64 target
+template <int N>
+void butterflies(uint64_t tt, int16_t* s) {
+    if constexpr (N < 3) {
+        butterfliesScalar<N>(tt, s);
+    } else {
+        constexpr int kVectors = 1 << (N - 3);
+        const __m128i lane_bits = _mm_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128);
+        const __m128i ones = _mm_set1_epi16(1);
+        const __m128i upper1 = _mm_setr_epi16(0, -1, 0, -1, 0, -1, 0, -1);
+        const __m128i upper2 = _mm_setr_epi16(0, 0, -1, -1, 0, 0, -1, -1);
+        const __m128i upper4 = _mm_setr_epi16(0, 0, 0, 0, -1, -1, -1, -1);
+        __m128i v[kVectors];
+        for (int k = 0; k < kVectors; ++k) {
+            __m128i byte = _mm_set1_epi16(static_cast<short>((tt >> (8 * k)) & 0xFF));
+            __m128i set = _mm_cmpeq_epi16(_mm_and_si128(byte, lane_bits), lane_bits);
+            __m128i x = _mm_add_epi16(ones, _mm_add_epi16(set, set));
+            x = innerPass(x, _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xB1), 0xB1), upper1);
+            x = innerPass(x, _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0x4E), 0x4E), upper2);
+            v[k] = innerPass(x, _mm_shuffle_epi32(x, 0x4E), upper4);
+        }
+        for (int h = 1; h < kVectors; h <<= 1) {
+            for (int i = 0; i < kVectors; i += 2 * h) {
+                for (int j = i; j < i + h; ++j) {
+                    __m128i a = v[j], b = v[j + h];
+                    v[j] = _mm_add_epi16(a, b);
+                    v[j + h] = _mm_sub_epi16(a, b);
+                }
+            }
+        }
+        for (int k = 0; k < kVectors; ++k) _mm_storeu_si128(reinterpret_cast<__m128i*>(s + 8 * k), v[k]);
+    }
+}
+
+#else
+
+template <int N>
+void butterflies(uint64_t tt, int16_t* s) {
+    butterfliesScalar<N>(tt, s);
+}
+
+#endif
+
+constexpr uint64_t mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Random key of every (weight, |coefficient|) pair, |coefficient| <= 64,
+// and the row offset of each w's weight
+constexpr int kMagnitudes = 65;
+struct PairKeys {
+    uint64_t keys[7 * kMagnitudes];
+    int weight_offset[64];
+    constexpr PairKeys() : keys(), weight_offset() {
+        for (int i = 0; i < 7 * kMagnitudes; ++i) keys[i] = mix(0x9E3779B97F4A7C15ULL * (i + 1));
+        for (int w = 0; w < 64; ++w) weight_offset[w] = TruthTable::countOnesPacked(w) * kMagnitudes;
+    }
+};
+constexpr PairKeys kPairKeys;
+
+template <int N>
+uint64_t signatureOf(uint64_t tt) {
+    int16_t s[1 << N];
+    butterflies<N>(tt, s);
+    // A sum of per-pair keys does not depend on the order of the coefficients
+    uint64_t hash = mix(N + 1);
+    for (int w = 0; w < (1 << N); ++w) {
+        int magnitude = s[w] < 0 ? -s[w] : s[w];
+        hash += kPairKeys.keys[kPairKeys.weight_offset[w] + magnitude];
+    }
+    return hash;
+}
+
+} // namespace
+
+void WalshSpectrum::transform(uint64_t tt, int n_vars, int16_t* spectrum) {
+    switch (n_vars) {
+    case 0: butterflies<0>(tt, spectrum); break;
+    case 1: butterflies<1>(tt, spectrum); break;
+    case 2: butterflies<2>(tt, spectrum); break;
+    case 3: butterflies<3>(tt, spectrum); break;
+    case 4: butterflies<4>(tt, spectrum); break;
+    case 5: butterflies<5>(tt, spectrum); break;
+    case 6: butterflies<6>(tt, spectrum); break;
+    default: throw std::invalid_argument("Walsh spectrum supports at most 6 variables");
+    }
+}
+
+uint64_t WalshSpectrum::signature(uint64_t tt, int n_vars) {
+    switch (n_vars) {
+    case 0: return signatureOf<0>(tt);
+    case 1: return signatureOf<1>(tt);
+    case 2: return signatureOf<2>(tt);
+    case 3: return signatureOf<3>(tt);
+    case 4: return signatureOf<4>(tt);
+    case 5: return signatureOf<5>(tt);
+    case 6: return signatureOf<6>(tt);
+    default: throw std::invalid_argument("Walsh spectrum supports at most 6 variables");
+    }
+}
+
+bool WalshSpectrum::mayBeEquivalent(uint64_t tt1, uint64_t tt2, int n_vars) {
+    // Onset sizes, |W(0)|, settle most pairs without a transform
+    int rows = 1 << n_vars;
+    uint64_t mask = n_vars == 6 ? ~0ULL : (1ULL << rows) - 1;
+    int ones1 = TruthTable::countOnesPacked(tt1 & mask), ones2 = TruthTable::countOnesPacked(tt2 & mask);
+    if (ones1 != ones2 && ones1 != rows - ones2) return false;
+    return signature(tt1, n_vars) == signature(tt2, n_vars);
+}
@@ -0,0 +1,28 @@
+#ifndef WALSH_SPECTRUM_H
+#define WALSH_SPECTRUM_H
+
+#include <cstdint>
+
+// Walsh-Hadamard spectra of packed truth tables (bit i = row i, up to 6
+// inputs) and the NPN-invariant signatures built from them.
+//
+// W(w) = sum over rows x of (-1)^(f(x) xor w.x). Negating an input flips the
+// sign of the coefficients whose w contains it, permuting inputs permutes the
+// w with their Hamming weight unchanged, and negating the output flips every
+// sign. So the multiset of (weight(w), |W(w)|) pairs is an NPN invariant:
+// functions with different signatures are never equivalent, while equal
+// signatures still need an exact check.
+class WalshSpectrum {
+public:
+    // Fills spectrum[0 .. 2^n_vars) using n_vars butterfly passes
+    static void transform(uint64_t tt, int n_vars, int16_t* spectrum);
+
+    // Order-independent 64-bit hash of the (weight, |coefficient|)
+    // multiset, also usable as a bucket key for classes
+    static uint64_t signature(uint64_t tt, int n_vars);
+
+    // False only if the functions are certainly not NPN-equivalent
+    static bool mayBeEquivalent(uint64_t tt1, uint64_t tt2, int n_vars);
+};
+
+#endif // WALSH_SPECTRUM_H
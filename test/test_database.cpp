@@ -0,0 +1,647 @@
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include "../src/npn_database.h"
+#include "../src/mig_synthesizer.h"
+#include "../src/query_server.h"
+#include "../src/record_writer.h"
+#include "../src/checkpoint.h"
+#include "../src/compute_driver.h"
+#include "../src/progress_reporter.h"
+#include "../src/utils.h"
+#include "../src/npn_classifier.h"
+#include "../src/truth_table.h"
+#include <cstring>
+#include <set>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+const std::string kDbPath = "test_db/npn_3var.db";
+
+void testParseText() {
+    std::cout << "Testing text database parsing..." << std::endl;
+    
+    std::string text =
+        "CLASS 00010111\n"
+        "POINT 1 1\n"
+        "Gate 4: MAJ(x1, x2, x3)\n"
+        "Output: x4\n"
+        "TIME 1e-05\n"
+        "---\n"
+        "CLASS 00000000\n"
+        "Output: x0\n"
+        "---\n"
+        "CLASS 01111111\n"
+        "Gate 4: MAJ(¬x0, x1, x2)\n"
+        "Gate 5: MAJ(¬x0, x3, x4)\n"
+        "Output: x5\n"
+        "---\n";
+    
+    auto classes = NPNDatabase::parseText(text);
+    assert(classes.size() == 3);
+    assert(classes[0].representative == "00010111");
+    assert(classes[0].points.size() == 1);
+    assert(classes[0].points[0].validate("00010111"));
+    assert(classes[1].points[0].validate("00000000"));
+    assert(classes[2].points[0].size() == 2);
+    assert(classes[2].points[0].validate("01111111"));
+    
+    std::cout << "  ✓ Parsed " << classes.size() << " classes" << std::endl;
+}
+
+void testBinaryRoundTrip() {
+    std::cout << "\nTesting binary database round trip..." << std::endl;
+    
+    std::vector<std::string> reps = {"01101001", "00010111", "00000001", "00000000"};
+    std::vector<DatabaseClass> classes;
+    for (const auto& rep : reps) {
+        classes.push_back({rep, {}});
+        for (const auto& mig : synthesizeParetoMIGs(rep)) {
+            classes.back().points.push_back(*mig);
+        }
+    }
+    NPNDatabase::writeBinary(classes, kDbPath);
+    
+    NPNDatabase db(kDbPath);
+    assert(db.numVars() == 3);
+    assert(db.size() == reps.size());
+    
+    for (const auto& rep : reps) {
+        DatabaseClass cls;
+        assert(db.find(rep, cls));
+        assert(!cls.points.empty());
+        for (const auto& mig : cls.points) {
+            assert(mig.validate(rep));
+        }
+    }
+    
+    DatabaseClass missing;
+    assert(!db.find("00111100", missing));
+    assert(!db.find("0001", missing));
+    
+    std::cout << "  ✓ All " << db.size() << " classes found after mmap" << std::endl;
+}
+
+void testCompressedDatabase() {
+    std::cout << "\nTesting compressed database..." << std::endl;
+    
+    const std::string path = "test_db/npn_3var_z.db";
+    std::vector<DatabaseClass> classes;
+    for (uint64_t packed = 1; packed < 256; packed += 5) {
+        std::string tt = TruthTable::binaryToTruthTable(packed, 3);
+        classes.push_back({tt, {}});
+        for (const auto& mig : synthesizeParetoMIGs(tt)) {
+            classes.back().points.push_back(*mig);
+        }
+    }
+    // Small blocks so lookups land at block starts, middles and ends
+    NPNDatabase::writeCompressed(classes, path, 4);
+    
+    NPNDatabase db(path);
+    assert(db.isCompressed());
+    assert(db.numVars() == 3);
+    assert(db.size() == classes.size());
+    for (const auto& cls : classes) {
+        DatabaseClass found;
+        assert(db.find(cls.representative, found));
+        assert(found.points.size() == cls.points.size());
+        for (size_t p = 0; p < cls.points.size(); ++p) {
+            assert(found.points[p].size() == cls.points[p].size());
+            assert(found.points[p].validate(cls.representative));
+        }
+    }
+    
+    DatabaseClass missing;
+    for (uint64_t packed : {0, 2, 254, 255}) {
+        assert(!db.find(TruthTable::binaryToTruthTable(packed, 3), missing));
+    }
+    
+    std::remove(path.c_str());
+    std::cout << "  ✓ " << db.size() << " classes found with one block decode each" << std::endl;
+}
+
+void testInvalidDatabase() {
+    std::cout << "\nTesting invalid database handling..." << std::endl;
+    
+    bool threw = false;
+    try {
+        NPNDatabase db("test_db/does_not_exist.db");
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "  ✓ Missing database rejected" << std::endl;
+}
+
+void testRecordWriter() {
+    std::cout << "\nTesting streaming record writer..." << std::endl;
+    
+    std::vector<DatabaseClass> classes;
+    for (const auto& rep : {"00010111", "01101001", "00000000"}) {
+        classes.push_back({rep, {}});
+        for (const auto& mig : synthesizeParetoMIGs(rep)) {
+            classes.back().points.push_back(*mig);
+        }
+    }
+    
+    // Tiny blocks force writes in the middle of the stream
+    const std::string text_path = "test_db/records.txt";
+    const std::string binary_path = "test_db/records.bin";
+    {
+        RecordWriter text(text_path, 3, RecordWriter::Format::Text, 0, 16);
+        RecordWriter binary(binary_path, 3, RecordWriter::Format::Binary, 2);
+        for (const auto& cls : classes) {
+            text.write(cls, 0.5);
+            binary.write(cls, 0.5);
+        }
+        assert(text.count() == classes.size());
+    }
+    
+    auto from_text = NPNDatabase::parseText(Utils::loadFromTxt(text_path));
+    std::string stream = Utils::loadFromTxt(binary_path);
+    assert(NPNDatabase::isRecordStream(stream));
+    auto from_binary = NPNDatabase::parseRecords(stream);
+    assert(from_text.size() == classes.size() && from_binary.size() == classes.size());
+    for (size_t i = 0; i < classes.size(); ++i) {
+        assert(from_text[i].representative == classes[i].representative);
+        assert(from_binary[i].representative == classes[i].representative);
+        assert(from_binary[i].points.size() == classes[i].points.size());
+        for (const auto& mig : from_binary[i].points) {
+            assert(mig.validate(classes[i].representative));
+        }
+    }
+    
+    // A record cut short by a crash is dropped, earlier ones survive
+    auto truncated = NPNDatabase::parseRecords(stream.substr(0, stream.size() - 1));
+    assert(truncated.size() == classes.size() - 1);
+    
+    std::remove(text_path.c_str());
+    std::remove(binary_path.c_str());
+    std::cout << "  ✓ Text and binary records read back" << std::endl;
+}
+
+void testCheckpointResume() {
+    std::cout << "\nTesting checkpoint and resume..." << std::endl;
+    
+    const std::string checkpoint_path = "test_db/job.checkpoint";
+    const std::string output_path = "test_db/job.txt";
+    std::vector<std::string> reps = {"00000000", "00010111", "01101001"};
+    
+    // First run: two classes done at the checkpoint, a third torn by a crash
+    Checkpoint saved(checkpoint_path, 0);
+    saved.n_vars = 3;
+    saved.cursor = 256;
+    saved.classes = reps;
+    {
+        RecordWriter writer(output_path, 3);
+        for (size_t i = 0; i < 2; ++i) {
+            writer.write({reps[i], {*synthesizeOptimalMIG(reps[i])}});
+        }
+        writer.flush(true);
+        saved.completed = 2;
+        saved.output_bytes = writer.offset();
+        assert(saved.due());
+        saved.save();
+        writer.write({reps[2], {*synthesizeOptimalMIG(reps[2])}});
+    }
+    
+    Checkpoint loaded(checkpoint_path);
+    assert(loaded.load());
+    assert(loaded.n_vars == 3 && loaded.cursor == 256);
+    assert(loaded.classes == reps);
+    assert(loaded.completed == 2 && loaded.output_bytes == saved.output_bytes);
+    
+    // Resuming drops the torn record and appends the remaining class once
+    {
+        RecordWriter writer(output_path, 3, RecordWriter::Format::Text, 0, 1 << 20,
+                            static_cast<int64_t>(loaded.output_bytes));
+        for (size_t i = loaded.completed; i < reps.size(); ++i) {
+            writer.write({reps[i], {*synthesizeOptimalMIG(reps[i])}});
+        }
+    }
+    auto classes = NPNDatabase::parseText(Utils::loadFromTxt(output_path));
+    assert(classes.size() == reps.size());
+    for (size_t i = 0; i < reps.size(); ++i) {
+        assert(classes[i].representative == reps[i]);
+        assert(classes[i].points[0].validate(reps[i]));
+    }
+    
+    loaded.remove();
+    assert(!Checkpoint(checkpoint_path).load());
+    std::remove(output_path.c_str());
+    std::cout << "  ✓ Resumed after " << loaded.completed << " of " << reps.size() << " classes" << std::endl;
+}
+
+void testComputeDriver() {
+    std::cout << "\nTesting pipelined compute driver..." << std::endl;
+    
+    ComputeOptions options;
+    options.n_vars = 3;
+    options.threads = 3;
+    options.queue_capacity = 2;
+    options.output = "test_db/compute_full.txt";
+    options.status_file = "test_db/compute_status.json";
+    ComputeStats stats = ComputeDriver::run(options);
+    assert(stats.functions == 256);
+    assert(stats.classes == 14 && stats.synthesized == 14 && stats.failed == 0);
+    // Workers stay within queue_capacity + threads of the writer
+    assert(stats.max_pending >= 1 && stats.max_pending <= 5);
+    std::string status = Utils::loadFromTxt(options.status_file);
+    assert(status.find("\"state\": \"done\", \"functions\": 256, \"total_functions\": 256, "
+                       "\"classes\": 14, \"synthesized\": 14") != std::string::npos);
+    options.status_file.clear();
+    auto full = NPNDatabase::parseText(Utils::loadFromTxt(options.output));
+    assert(full.size() == 14);
+    for (const auto& cls : full) {
+        assert(cls.representative == NPNClassifier::getNPNRepresentative(cls.representative));
+        assert(cls.points[0].validate(cls.representative));
+    }
+    
+    // Stopping early leaves a checkpoint that the next run continues from
+    options.output = "test_db/compute_resumed.txt";
+    options.max_classes = 5;
+    stats = ComputeDriver::run(options);
+    assert(stats.classes == 5);
+    Checkpoint checkpoint(ComputeDriver::checkpointPath(options.output));
+    assert(checkpoint.load() && checkpoint.completed == 5);
+    
+    options.max_classes = 0;
+    options.resume = true;
+    stats = ComputeDriver::run(options);
+    assert(stats.classes == 14 && stats.synthesized == 9);
+    assert(!checkpoint.load());
+    
+    auto resumed = NPNDatabase::parseText(Utils::loadFromTxt(options.output));
+    assert(resumed.size() == full.size());
+    for (size_t i = 0; i < full.size(); ++i) {
+        assert(resumed[i].representative == full[i].representative);
+    }
+    
+    std::remove("test_db/compute_full.txt");
+    std::remove("test_db/compute_status.json");
+    std::remove(options.output.c_str());
+    std::cout << "  ✓ " << full.size() << " classes, identical after resume, reorder backlog bounded" << std::endl;
+}
+
+void testPartitionedCompute() {
+    std::cout << "\nTesting partitioned compute and merge..." << std::endl;
+    
+    int partition = 0, partitions = 0;
+    assert(ComputeDriver::parsePartition("2/8", partition, partitions) && partition == 2 && partitions == 8);
+    assert(!ComputeDriver::parsePartition("8/8", partition, partitions));
+    assert(!ComputeDriver::parsePartition("1/", partition, partitions));
+    assert(!ComputeDriver::parsePartition("-1/4", partition, partitions));
+    assert(ComputeDriver::partitionOutput("data/npn_5var.txt", 2, 8) == "data/npn_5var.part2of8.txt");
+    assert(ComputeDriver::parsePartitionOutput("data/npn_5var.part2of8.txt", partition, partitions));
+    assert(partition == 2 && partitions == 8);
+    assert(!ComputeDriver::parsePartitionOutput("data/npn_5var.txt", partition, partitions));
+    assert(!ComputeDriver::parsePartitionOutput("data.part1of2/npn_5var.txt", partition, partitions));
+    
+    // Three slices own disjoint classes that together are all 14
+    ComputeOptions options;
+    options.n_vars = 3;
+    options.threads = 2;
+    options.progress_interval_ms = 0;
+    options.partitions = 3;
+    std::vector<std::string> parts;
+    size_t classes = 0;
+    uint64_t functions = 0;
+    for (int i = 0; i < 3; ++i) {
+        // A custom output gets the slice suffix too, but not twice
+        options.partition = i;
+        options.output = i == 0 ? "test_db/compute_parts.txt"
+                                : ComputeDriver::partitionOutput("test_db/compute_parts.txt", i, 3);
+        ComputeStats stats = ComputeDriver::run(options);
+        options.output = ComputeDriver::partitionOutput("test_db/compute_parts.txt", i, 3);
+        assert(access(options.output.c_str(), F_OK) == 0);
+        assert(stats.failed == 0 && stats.synthesized == stats.classes);
+        classes += stats.classes;
+        functions += stats.functions;
+        parts.push_back(options.output);
+    }
+    assert(classes == 14 && functions == 256);
+    
+    // Merging in any order gives the same sorted, duplicate-free database
+    parts.push_back(parts.front());
+    auto merged = ComputeDriver::mergePartitions(parts);
+    std::vector<std::string> reversed(parts.rbegin(), parts.rend());
+    auto merged_reversed = ComputeDriver::mergePartitions(reversed);
+    assert(merged.size() == 14 && merged_reversed.size() == 14);
+    auto expected = NPNClassifier::findNPNClasses(TruthTable::generateAllTruthTables(3));
+    std::set<std::string> reps;
+    for (size_t i = 0; i < merged.size(); ++i) {
+        reps.insert(merged[i].representative);
+        assert(merged[i].points[0].validate(merged[i].representative));
+        assert(merged[i].points[0].toCompact() == merged_reversed[i].points[0].toCompact());
+        if (i > 0) {
+            assert(TruthTable::truthTableToBinary(merged[i - 1].representative) <
+                   TruthTable::truthTableToBinary(merged[i].representative));
+        }
+    }
+    assert(reps == std::set<std::string>(expected.begin(), expected.end()));
+    
+    // Merges that would miss classes are refused: a missing slice, slices of
+    // different splits, and a slice that stopped early (it still has a
+    // checkpoint)
+    auto refused = [](const std::vector<std::string>& paths) {
+        try {
+            ComputeDriver::mergePartitions(paths);
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    };
+    assert(refused({parts[0], parts[2]}));
+    assert(refused({parts[0], parts[1], parts[2], "test_db/compute_full.part1of2.txt"}));
+    options.partition = 1;
+    options.max_classes = 1;
+    options.output = ComputeDriver::partitionOutput("test_db/compute_unfinished.txt", 1, 3);
+    ComputeDriver::run(options);
+    assert(refused({parts[0], options.output, parts[2]}));
+    
+    for (int i = 0; i < 3; ++i) std::remove(parts[i].c_str());
+    std::remove(options.output.c_str());
+    std::remove(ComputeDriver::checkpointPath(options.output).c_str());
+    std::cout << "  ✓ " << merged.size() << " classes merged from 3 partitions" << std::endl;
+}
+
+void testBoundDatabase() {
+    std::cout << "\nTesting function lookups and bounded compute..." << std::endl;
+    
+    std::vector<std::string> functions;
+    for (int f = 0; f < 256; ++f) functions.push_back(TruthTable::binaryToTruthTable(f, 3));
+    std::vector<DatabaseClass> classes;
+    for (const auto& rep : NPNClassifier::findNPNClasses(functions)) {
+        classes.push_back({rep, {}});
+        classes.back().points.push_back(*synthesizeOptimalMIG(rep));
+    }
+    const std::string path = "test_db/bound_3var.db";
+    NPNDatabase::writeBinary(classes, path);
+    NPNDatabase db(path);
+    
+    // Every function gets its class optimum rewired onto it
+    for (const auto& tt : functions) {
+        MIG mig;
+        assert(db.findFunction(tt, mig));
+        assert(mig.validate(tt));
+        assert(mig.size() == synthesizeOptimalMIG(tt)->size());
+    }
+    MIG mig;
+    assert(!db.findFunction("0110", mig));
+    
+    // Exact 4-input classes seeded from the 3-input database
+    ComputeOptions options;
+    options.n_vars = 4;
+    options.threads = 2;
+    options.backend = ComputeOptions::Backend::Exact;
+    options.max_classes = 12;
+    options.progress_interval_ms = 0;
+    options.output = "test_db/compute_bounded.txt";
+    options.bound_database = path;
+    ComputeStats stats = ComputeDriver::run(options);
+    assert(stats.synthesized == 12 && stats.failed == 0);
+    for (const auto& cls : NPNDatabase::parseText(Utils::loadFromTxt(options.output))) {
+        assert(cls.points[0].validate(cls.representative));
+        assert(cls.points[0].size() == synthesizeOptimalMIG(cls.representative)->size());
+    }
+    std::remove(options.output.c_str());
+    std::remove(ComputeDriver::checkpointPath(options.output).c_str());
+    
+    // A wrong bound database is an option error, not an I/O failure
+    options.n_vars = 5;
+    bool threw = false;
+    try {
+        ComputeDriver::run(options);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    options.n_vars = 4;
+    options.bound_database = "test_db/does_not_exist.db";
+    threw = false;
+    try {
+        ComputeDriver::run(options);
+    } catch (const std::invalid_argument& e) {
+        threw = std::string(e.what()).find("does_not_exist.db") != std::string::npos;
+    }
+    assert(threw);
+    std::remove(path.c_str());
+    std::cout << "  ✓ 256 functions from " << classes.size() << " classes, 12 bounded exact classes" << std::endl;
+}
+
+void testProgressReporter() {
+    std::cout << "\nTesting progress reporting..." << std::endl;
+    
+    ProgressCounters counters;
+    ProgressReporter progress(counters, 1000, 0);
+    progress.start();
+    ProgressSnapshot idle = progress.sample();
+    assert(idle.eta_seconds < 0);
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    counters.functions = 250;
+    counters.classes = 10;
+    counters.synthesized = 4;
+    ProgressSnapshot s = progress.sample();
+    assert(s.functions_per_second > 0 && s.classes_per_second > 0);
+    // Enumeration needs 3x the time spent so far, the 6 queued classes 1.5x
+    assert(s.eta_seconds > 2.5 * s.elapsed_seconds && s.eta_seconds < 3.5 * s.elapsed_seconds);
+    assert(s.toLine().find("25.0% functions (250/1000") != std::string::npos);
+    progress.stop();
+    
+    assert(ProgressReporter::formatDuration(42) == "42s");
+    assert(ProgressReporter::formatDuration(185) == "3m05s");
+    assert(ProgressReporter::formatDuration(3720) == "1h02m");
+    
+    std::cout << "  ✓ Rates and ETA derived from sampled counters" << std::endl;
+}
+
+// Feeds input through a pipe into serveStream (or serveBatch with the given
+// window) and returns everything written
+std::string serve(QueryServer& server, const std::string& input, size_t window = 0) {
+    int in_pipe[2], out_pipe[2];
+    if (pipe(in_pipe) != 0 || pipe(out_pipe) != 0) return "";
+    ssize_t written = write(in_pipe[1], input.data(), input.size());
+    assert(written == (ssize_t)input.size());
+    close(in_pipe[1]);
+    if (window > 0) {
+        server.serveBatch(in_pipe[0], out_pipe[1], window);
+    } else {
+        server.serveStream(in_pipe[0], out_pipe[1]);
+    }
+    close(in_pipe[0]);
+    close(out_pipe[1]);
+    
+    std::string output;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = read(out_pipe[0], buffer, sizeof(buffer))) > 0) output.append(buffer, n);
+    close(out_pipe[0]);
+    return output;
+}
+
+void testQueryServer() {
+    std::cout << "\nTesting query server..." << std::endl;
+    
+    // Database holding the classes of XOR3 and MAJ3
+    std::string xor_rep = NPNClassifier::getNPNRepresentative("10010110");
+    std::string maj_rep = NPNClassifier::getNPNRepresentative("11101000");
+    std::vector<DatabaseClass> classes;
+    for (const auto& rep : {xor_rep, maj_rep}) {
+        classes.push_back({rep, {}});
+        classes.back().points.push_back(*synthesizeOptimalMIG(rep));
+    }
+    NPNDatabase::writeBinary(classes, kDbPath);
+    
+    QueryServer server(4, "test_db", 10000);
+    
+    // Last request has no trailing newline
+    std::string output = serve(server, "10010110\n11101000\n0110\n1x\n00010111");
+    std::istringstream lines(output);
+    std::string line;
+    std::vector<std::string> answers;
+    while (std::getline(lines, line)) answers.push_back(line);
+    assert(answers.size() == 5);
+    
+    // Answers come back in request order
+    std::string xor2_rep = NPNClassifier::getNPNRepresentative("0110");
+    assert(answers[0].rfind("10010110 " + xor_rep + " db ", 0) == 0);
+    assert(answers[1].rfind("11101000 " + maj_rep + " db 1 1 ", 0) == 0);
+    assert(answers[2].rfind("0110 " + xor2_rep + " synth 3 2 ", 0) == 0);
+    assert(answers[3] == "1x ERROR invalid truth table");
+    assert(answers[4].rfind("00010111 " + maj_rep + " db ", 0) == 0);
+    
+    std::istringstream compact(answers[2].substr(std::strlen("0110 0110 synth 3 2 ")));
+    MIG mig(2);
+    bool parsed = MIG::fromCompact(compact, 2, mig);
+    assert(parsed);
+    assert(mig.validate(xor2_rep));
+    
+    // Binary protocol: n_vars byte followed by the packed table
+    std::string request(9, '\0');
+    request[0] = 3;
+    uint64_t packed = 0xE8;  // MAJ(x1, x2, x3)
+    std::memcpy(&request[1], &packed, sizeof(packed));
+    std::string reply = serve(server, request + request);
+    assert(reply.size() == 2 * (sizeof(QueryServer::BinaryAnswer) + sizeof(NPNDatabase::NodeRecord)));
+    QueryServer::BinaryAnswer answer;
+    std::memcpy(&answer, reply.data(), sizeof(answer));
+    assert(answer.status == QueryServer::Database);
+    assert(answer.num_gates == 1 && answer.depth == 1);
+    
+    std::cout << "  ✓ Text and binary requests answered in order" << std::endl;
+}
+
+// One query over a fresh connection; returns the answer line
+std::string querySocket(const std::string& socket_path, const std::string& request) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    std::string output;
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+        ssize_t written = write(fd, request.data(), request.size());
+        assert(written == (ssize_t)request.size());
+        shutdown(fd, SHUT_WR);
+        char buffer[4096];
+        ssize_t n;
+        while ((n = read(fd, buffer, sizeof(buffer))) > 0) output.append(buffer, n);
+    }
+    close(fd);
+    return output;
+}
+
+void testSocketClients() {
+    std::cout << "\nTesting socket server with short-lived clients..." << std::endl;
+    
+    const std::string socket_path = "test_db/query.sock";
+    QueryServer server(2, "test_db", 10000);
+    std::thread listener([&]() { server.serveSocket(socket_path); });
+    std::string answer;
+    for (int attempt = 0; attempt < 100 && answer.empty(); ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        answer = querySocket(socket_path, "0110\n");
+    }
+    assert(answer.compare(0, 5, "0110 ") == 0);
+    
+    // Finished clients are joined on later accepts instead of piling up
+    const int kClients = 40;
+    for (int c = 0; c < kClients; ++c) {
+        assert(querySocket(socket_path, "0110\n") == answer);
+    }
+    size_t threads = server.numClientThreads();
+    assert(threads < 10);
+    
+    server.stop();
+    listener.join();
+    assert(server.numClientThreads() == 0);
+    std::cout << "  ✓ " << kClients << " clients served, " << threads << " thread(s) left to join" << std::endl;
+}
+
+void testBatchMode() {
+    std::cout << "\nTesting streaming batch mode..." << std::endl;
+    
+    QueryServer server(4, "test_db", 10000);
+    
+    // Far more requests than reorder slots, mixing binary and hex notation
+    std::string input;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 200; ++i) {
+        std::string tt = TruthTable::binaryToTruthTable((i * 37) & 0xFF, 3);
+        expected.push_back(NPNClassifier::getNPNRepresentative(tt));
+        if (i % 2) {
+            char hex[8];
+            std::snprintf(hex, sizeof(hex), "0x%02x", (i * 37) & 0xFF);
+            input += std::string(hex) + "\n";
+        } else {
+            input += tt + "\n";
+        }
+    }
+    
+    std::istringstream lines(serve(server, input, 4));
+    std::string request, rep;
+    std::string line;
+    size_t count = 0;
+    while (std::getline(lines, line)) {
+        std::istringstream fields(line);
+        fields >> request >> rep;
+        assert(rep == expected[count]);
+        count++;
+    }
+    assert(count == expected.size());
+    
+    std::cout << "  ✓ " << count << " answers streamed in input order" << std::endl;
+}
+
+int main() {
+    std::cout << std::string(50, '=') << std::endl;
+    std::cout << "NPN DATABASE TESTS" << std::endl;
+    std::cout << std::string(50, '=') << std::endl;
+    
+    testParseText();
+    testBinaryRoundTrip();
+    testCompressedDatabase();
+    testInvalidDatabase();
+    testRecordWriter();
+    testCheckpointResume();
+    testComputeDriver();
+    testPartitionedCompute();
+    testBoundDatabase();
+    testProgressReporter();
+    testQueryServer();
+    testSocketClients();
+    testBatchMode();
+    std::remove(kDbPath.c_str());
+    std::remove("test_db/synthesis_cache.log");
+    
+    std::cout << "\n" << std::string(50, '=') << std::endl;
+    std::cout << "ALL DATABASE TESTS PASSED ✓" << std::endl;
+    std::cout << std::string(50, '=') << std::endl;
+    
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/profiler.h"
+#include "../src/utils.h"
+
+// The logger keeps files open, so each test writes its own
+const std::string kConcurrentLog = "test_logs/concurrent.log";
+const std::string kFilterLog = "test_logs/filter.log";
+
+std::vector<std::string> readLog(const std::string& path) {
+    Utils::flushLog();
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) lines.push_back(line);
+    return lines;
+}
+
+void testConcurrentLogging() {
+    std::cout << "Testing concurrent logging..." << std::endl;
+    
+    // More messages than ring slots, so producers also wait for the writer.
+    // Debug messages stay out of the console.
+    Utils::setLogLevel(LogLevel::Debug);
+    const int threads = 4, per_thread = 3000;
+    std::vector<std::thread> producers;
+    for (int t = 0; t < threads; ++t) {
+        producers.emplace_back([t]() {
+            for (int i = 0; i < per_thread; ++i) {
+                Utils::logMessage("thread " + std::to_string(t) + " message " + std::to_string(i),
+                                  kConcurrentLog, LogLevel::Debug);
+            }
+        });
+    }
+    for (auto& p : producers) p.join();
+    Utils::setLogLevel(LogLevel::Info);
+    
+    auto lines = readLog(kConcurrentLog);
+    assert(lines.size() == threads * per_thread);
+    
+    // Each producer's messages stay in order
+    std::vector<int> next(threads, 0);
+    for (const auto& line : lines) {
+        assert(line[0] == '[' && line.find("] DEBUG thread ") != std::string::npos);
+        int t = std::stoi(line.substr(line.find("thread ") + 7));
+        int i = std::stoi(line.substr(line.find("message ") + 8));
+        assert(i == next[t]);
+        next[t]++;
+    }
+    
+    std::cout << "  ✓ " << lines.size() << " messages written in order" << std::endl;
+}
+
+void testLevelsAndRateLimit() {
+    std::cout << "\nTesting level filtering and rate limiting..." << std::endl;
+    
+    Utils::setLogLevel(LogLevel::Error);
+    Utils::logMessage("dropped", kFilterLog, LogLevel::Warning);
+    Utils::logMessage("kept", kFilterLog, LogLevel::Error);
+    Utils::setLogLevel(LogLevel::Info);
+    Utils::logMessage("dropped debug", kFilterLog, LogLevel::Debug);
+    MIG_LOG_DEBUG("compiled out");
+    
+    int logged = 0;
+    for (int i = 0; i < 100; ++i) {
+        if (Utils::logRateLimited("progress", "class " + std::to_string(i), 60000, kFilterLog)) logged++;
+    }
+    assert(logged == 1);
+    bool final_logged = Utils::logRateLimited("progress", "final", 0, kFilterLog);
+    assert(final_logged);
+    
+    auto lines = readLog(kFilterLog);
+    assert(lines.size() == 3);
+    assert(lines[0].find("ERROR kept") != std::string::npos);
+    assert(lines[1].find("class 0") != std::string::npos);
+    assert(lines[2].find("final (99 similar suppressed)") != std::string::npos);
+    
+    std::cout << "  ✓ Filtered and throttled messages dropped" << std::endl;
+}
+
+void testProfiler() {
+    std::cout << "\nTesting profiling regions and counters..." << std::endl;
+    
+    Profiler::reset();
+    // Worker threads fold their regions into the totals when they exit
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            MIG_PROFILE_SCOPE("outer");
+            for (int i = 0; i < 100; ++i) {
+                MIG_PROFILE_SCOPE("inner");
+                MIG_PROFILE_COUNT("test.items", 2);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    {
+        // Live regions of this thread are merged too
+        Utils::Timer timer("outer");
+        MIG_PROFILE_COUNT("test.items", 1);
+    }
+    assert(Profiler::counter("test.items") == 801);
+    
+    std::string json = Profiler::toJson();
+    assert(json.find("\"name\": \"outer\", \"calls\": 5") != std::string::npos);
+    assert(json.find("\"name\": \"inner\", \"calls\": 400") != std::string::npos);
+    assert(json.find("\"test.items\": 801") != std::string::npos);
+    std::string folded = Profiler::toFolded();
+    assert(folded.find("outer;inner ") != std::string::npos || folded.find("outer ") != std::string::npos);
+    
+    // Disabled scopes and counters record nothing
+    Profiler::setEnabled(false);
+    {
+        MIG_PROFILE_SCOPE("disabled");
+        MIG_PROFILE_COUNT("test.items", 5);
+    }
+    Profiler::setEnabled(true);
+    assert(Profiler::counter("test.items") == 801);
+    assert(Profiler::toJson().find("disabled") == std::string::npos);
+    
+    Profiler::reset();
+    assert(Profiler::counter("test.items") == 0);
+    
+    std::cout << "  ✓ Nested regions and counters merged across threads" << std::endl;
+}
+
+int main() {
+    std::cout << std::string(50, '=') << std::endl;
+    std::cout << "LOGGING TESTS" << std::endl;
+    std::cout << std::string(50, '=') << std::endl;
+    
+    std::remove(kConcurrentLog.c_str());
+    std::remove(kFilterLog.c_str());
+    testConcurrentLogging();
+    testLevelsAndRateLimit();
+    testProfiler();
+    std::remove(kConcurrentLog.c_str());
+    std::remove(kFilterLog.c_str());
+    
+    std::cout << "\n" << std::string(50, '=') << std::endl;
+    std::cout << "ALL LOGGING TESTS PASSED ✓" << std::endl;
+    std::cout << std::string(50, '=') << std::endl;
+    
+    return 0;
+}
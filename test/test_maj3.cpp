@@ -1,8 +1,12 @@
 #include <iostream>
 #include <cassert>
+#include <random>
+#include <stdexcept>
 #include "../src/mig_structure.h"
+#include "../src/mig_rewriter.h"
 #include "../src/npn_classifier.h"
 #include "../src/mig_synthesizer.h"
+#include "../src/profiler.h"
 #include "../src/truth_table.h"
 
 void testMAJ3Basic() {
@@ -88,6 +92,102 @@ void testANDORWithMAJ() {
     std::cout << "  ✓ OR(x1,x2) = MAJ(1,x1,x2) = " << or_tt << std::endl;
 }
 
+void testDepthRewriting() {
+    std::cout << "\nTesting depth rewriting with the majority axioms..." << std::endl;
+    
+    // AND chain M(...M(M(x1, x2, 0), x3, 0)..., x10, 0): associativity over
+    // the shared constant rebalances it
+    MIG chain(10);
+    int node = 1;
+    for (int v = 2; v <= 10; ++v) node = chain.addGate({node, v, 0});
+    chain.setOutput(node, 0);
+    std::string chain_tt = chain.getTruthTable();
+    auto passes = MIGRewriter::optimizeDepth(chain);
+    assert(chain.getTruthTable() == chain_tt);
+    assert(chain.depth() == 4 && chain.size() == 9);
+    
+    // One graph per rule, z = M(x1, x2, x3) being the deep fanin:
+    //   Omega.A   M(x6, x5, M(x4, x5, z))  -> M(z, x5, M(x4, x5, x6))
+    //   Psi.C     M(x6, x5, M(x4, !x5, z)) -> M(z, x6, M(x4, x6, x5))
+    //   Omega.D   M(x6, x7, M(x4, x5, z))  -> M(M(x6, x7, x4), M(x6, x7, x5), z)
+    // all from depth 3 to 2; Omega.D trades a gate for the level
+    struct RuleCase {
+        const char* counter;
+        int second_polarity;        // of x5 in the inner gate
+        int top_input;              // second fanin of the top gate
+        int size;
+    };
+    for (const auto& rule : {RuleCase{"rewrite.associativity", 0, 5, 3},
+                             RuleCase{"rewrite.complementary_associativity", 1, 5, 3},
+                             RuleCase{"rewrite.distributivity", 0, 7, 4}}) {
+        MIG mig(7);
+        int z = mig.addGate({1, 2, 3});
+        int inner = mig.addGate({4, 5, z}, {0, rule.second_polarity, 0});
+        mig.setOutput(mig.addGate({6, rule.top_input, inner}), 0);
+        std::string tt = mig.getTruthTable();
+        Profiler::reset();
+        MIGRewriter::optimizeDepth(mig);
+        assert(mig.getTruthTable() == tt);
+        assert(mig.depth() == 2 && mig.size() == rule.size);
+        assert(Profiler::counter(rule.counter) > 0);
+    }
+    
+    // Area: M(M(x1, x2, x3), M(x1, x2, x4), x5) -> M(x1, x2, M(x3, x4, x5))
+    // keeps depth 2 and saves a gate
+    MIG shared(5);
+    int a = shared.addGate({1, 2, 3});
+    int b = shared.addGate({1, 2, 4});
+    shared.setOutput(shared.addGate({a, b, 5}), 0);
+    std::string shared_tt = shared.getTruthTable();
+    Profiler::reset();
+    MIGRewriter::optimizeDepth(shared);
+    assert(shared.getTruthTable() == shared_tt);
+    assert(shared.depth() == 2 && shared.size() == 2);
+    assert(Profiler::counter("rewrite.area_distributivity") > 0);
+    assert(Profiler::counter("rewrite.distributivity") == 0);
+    Profiler::reset();
+    
+    // Random multi-output graphs keep their functions, the depth never grows
+    // and every pass starts where the previous one ended
+    std::mt19937_64 rng(5);
+    for (int trial = 0; trial < 20; ++trial) {
+        MIG mig(7);
+        for (int g = 0; g < 80; ++g) {
+            int nodes = 8 + g;
+            auto pick = [&]() { return int(std::max<int>(1, nodes - 6) + rng() % std::min(6, nodes - 1)); };
+            mig.addGate({pick(), pick(), pick()}, {int(rng() & 1), int(rng() & 1), int(rng() & 1)});
+        }
+        mig.setOutput(mig.n_vars + 80, 0);
+        mig.addOutput(mig.n_vars + 75, 1);
+        std::string tt0 = mig.getTruthTable(0), tt1 = mig.getTruthTable(1);
+        int depth = mig.depth();
+        passes = MIGRewriter::optimizeDepth(mig);
+        assert(mig.getTruthTable(0) == tt0 && mig.getTruthTable(1) == tt1);
+        assert(mig.depth() <= depth && passes.front().depth_before == depth);
+        for (size_t i = 0; i < passes.size(); ++i) {
+            assert(passes[i].depth_after <= passes[i].depth_before);
+            if (i > 0) {
+                assert(passes[i].depth_before == passes[i - 1].depth_after);
+                assert(passes[i].size_before == passes[i - 1].size_after);
+            }
+        }
+        assert(passes.back().depth_after == mig.depth() && passes.back().size_after == mig.size());
+    }
+    
+    MIG wide(2);
+    wide.addGate({0, 1, 2, 1});
+    bool threw = false;
+    try {
+        MIGRewriter::optimizeDepth(wide);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "  ✓ AND chain of 10 inputs rebalanced to depth " << chain.depth() << std::endl;
+    std::cout << "  ✓ Omega.A, Psi.C, Omega.D and area recovery each reach their expected depth" << std::endl;
+}
+
 int main() {
     std::cout << std::string(50, '=') << std::endl;
     std::cout << "MAJ-3 COMPREHENSIVE TESTS" << std::endl;
@@ -97,6 +197,7 @@ int main() {
     testMAJ3MIGConstruction();
     testMAJ3Synthesis();
     testANDORWithMAJ();
+    testDepthRewriting();
     
     std::cout << "\n" << std::string(50, '=') << std::endl;
     std::cout << "ALL MAJ-3 TESTS PASSED ✓" << std::endl;
@@ -1,10 +1,322 @@
 #include <iostream>
 #include <cassert>
 #include "../src/npn_classifier.h"
+#include "../src/npn_kernels.h"
+#include "../src/npn_matcher.h"
+#include "../src/npn_shuffle.h"
 #include "../src/truth_table.h"
+#include "../src/walsh_spectrum.h"
+#include <algorithm>
+#include <random>
+#include <set>
+#include <stdexcept>
+
+void testTruthTableRange() {
+    std::cout << "Testing lazy truth table ranges..." << std::endl;
+    
+    // Chunks cover the range in order
+    TruthTableRange all(3);
+    assert(all.size() == 256);
+    std::vector<uint64_t> chunk;
+    uint64_t expected = 0;
+    int chunks = 0;
+    while (all.nextChunk(chunk, 100)) {
+        for (uint64_t tt : chunk) assert(tt == expected++);
+        chunks++;
+    }
+    assert(expected == 256 && chunks == 3);
+    assert(TruthTable::generateAllTruthTables(2).size() == 16);
+    
+    // n=5 needs 64-bit counters; split parts are contiguous and near-equal
+    TruthTableRange n5(5);
+    assert(n5.size() == (1ULL << 32));
+    auto parts = n5.split(7);
+    assert(parts.size() == 7);
+    assert(parts.front().first() == 0 && parts.back().last() == (1ULL << 32));
+    for (size_t i = 1; i < parts.size(); ++i) {
+        assert(parts[i].first() == parts[i - 1].last());
+        assert(parts[i - 1].size() - parts[i].size() <= 1);
+    }
+    bool more = parts[3].nextChunk(chunk);
+    assert(more && chunk.size() == TruthTableRange::kDefaultChunk);
+    assert(chunk.front() == parts[3].first());
+    
+    std::cout << "  ✓ Ranges chunk and split correctly" << std::endl;
+}
+
+void testWideTruthTable() {
+    std::cout << "\nTesting multi-word truth tables..." << std::endl;
+    
+    std::mt19937_64 rng(7);
+    for (int n : {3, 6, 7, 8}) {
+        std::string tt(1 << n, '0');
+        for (auto& c : tt) c = '0' + (rng() & 1);
+        WideTruthTable wide = WideTruthTable::fromString(tt);
+        assert(wide.numVars() == n && wide.toString() == tt);
+        
+        // Flips and swaps agree with the string transforms
+        for (int v = 0; v < n; ++v) {
+            std::vector<int> neg(n, 0);
+            neg[v] = 1;
+            WideTruthTable flipped = wide;
+            flipped.flipVar(v);
+            assert(flipped.toString() == NPNClassifier::applyNegationPattern(tt, neg, 0));
+            assert(wide.countOnesCofactor(v, 0) + wide.countOnesCofactor(v, 1) == wide.countOnes());
+            for (int u = v + 1; u < n; ++u) {
+                std::vector<int> perm(n);
+                for (int i = 0; i < n; ++i) perm[i] = i;
+                std::swap(perm[u], perm[v]);
+                WideTruthTable swapped = wide;
+                swapped.swapVars(u, v);
+                assert(swapped.toString() == NPNClassifier::applyPermutation(tt, perm));
+            }
+        }
+        WideTruthTable negated = wide;
+        negated.complement();
+        assert(negated.countOnes() == (1ULL << n) - wide.countOnes());
+    }
+    
+    // Packed 64-bit tables stop at six inputs
+    bool threw = false;
+    try {
+        TruthTable::truthTableToBinary(std::string(128, '1'));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "  ✓ Multi-word operations match the string transforms" << std::endl;
+}
+
+void testSemiCanonicalForm() {
+    std::cout << "\nTesting semi-canonical NPN form..." << std::endl;
+    
+    std::mt19937_64 rng(11);
+    int trials = 0, matches = 0;
+    for (int n : {7, 8, 10, 12}) {
+        for (int t = 0; t < 50; ++t) {
+            WideTruthTable f(n);
+            for (uint64_t row = 0; row < (1ULL << n); ++row) f.setBit(row, rng() & 1);
+            
+            // Random NPN transform of f
+            WideTruthTable g = f;
+            for (int i = 0; i < 3 * n; ++i) g.swapVars(rng() % n, rng() % n);
+            for (int v = 0; v < n; ++v) {
+                if (rng() & 1) g.flipVar(v);
+            }
+            if (rng() & 1) g.complement();
+            
+            WideTruthTable form = NPNClassifier::getSemiCanonicalForm(f);
+            uint64_t ones = form.countOnes();
+            assert(ones == f.countOnes() || ones == (1ULL << n) - f.countOnes());
+            trials++;
+            if (form == NPNClassifier::getSemiCanonicalForm(g)) {
+                matches++;
+                assert(NPNClassifier::semiCanonicalHash(f) == NPNClassifier::semiCanonicalHash(g));
+            }
+        }
+    }
+    assert(matches * 100 >= trials * 95);
+    
+    // Fully symmetric functions collapse through the tie-breaking steps
+    WideTruthTable maj(9), maj_neg(9);
+    for (uint64_t row = 0; row < 512; ++row) {
+        maj.setBit(row, __builtin_popcountll(row) >= 5);
+        maj_neg.setBit(row, __builtin_popcountll(row ^ 0x0A5) >= 5);
+    }
+    assert(NPNClassifier::getSemiCanonicalForm(maj) == NPNClassifier::getSemiCanonicalForm(maj_neg));
+    
+    std::cout << "  ✓ " << matches << "/" << trials << " transformed functions share their form" << std::endl;
+}
+
+// Lexicographically smallest string over every transform, the slow way
+std::string referenceRepresentative(const std::string& tt) {
+    int n = TruthTable::getNumVars(tt);
+    std::vector<int> perm(n);
+    for (int i = 0; i < n; ++i) perm[i] = i;
+    std::string best = tt;
+    do {
+        for (int mask = 0; mask < (1 << n); ++mask) {
+            std::vector<int> neg(n);
+            for (int i = 0; i < n; ++i) neg[i] = (mask >> i) & 1;
+            for (int out = 0; out <= 1; ++out) {
+                best = std::min(best, NPNClassifier::applyNegationPattern(
+                                          NPNClassifier::applyPermutation(tt, perm), neg, out));
+            }
+        }
+    } while (std::next_permutation(perm.begin(), perm.end()));
+    return best;
+}
+
+void testCompiledKernels() {
+    std::cout << "\nTesting compile-time NPN kernels..." << std::endl;
+    
+    // Agrees with the exhaustive string search: every function up to 3
+    // inputs, random ones above (the reference is slow at 5 and 6)
+    for (int n = 1; n <= 3; ++n) {
+        for (const auto& tt : TruthTable::generateAllTruthTables(n)) {
+            assert(NPNClassifier::getNPNRepresentative(tt) == referenceRepresentative(tt));
+        }
+    }
+    std::mt19937_64 rng(5);
+    for (int n : {4, 5, 6}) {
+        int samples = n == 4 ? 50 : n == 5 ? 5 : 2;
+        for (int i = 0; i < samples; ++i) {
+            std::string tt = TruthTable::binaryToTruthTable(rng(), n);
+            assert(NPNClassifier::getNPNRepresentative(tt) == referenceRepresentative(tt));
+        }
+    }
+    
+    // One batch over every 4-input function finds the 222 classes
+    std::vector<uint64_t> tables(1 << 16), reps(1 << 16);
+    for (uint64_t f = 0; f < tables.size(); ++f) tables[f] = f;
+    NPNClassifier::canonizeBatch(tables.data(), reps.data(), tables.size(), 4);
+    std::set<uint64_t> classes(reps.begin(), reps.end());
+    assert(classes.size() == 222);
+    
+    // 5 and 6 inputs: a random transform keeps the representative
+    for (int n : {5, 6}) {
+        for (int i = 0; i < 5; ++i) {
+            std::string tt = TruthTable::binaryToTruthTable(rng(), n);
+            std::vector<int> perm(n), neg(n);
+            for (int v = 0; v < n; ++v) {
+                perm[v] = v;
+                neg[v] = rng() & 1;
+            }
+            std::shuffle(perm.begin(), perm.end(), rng);
+            std::string moved = NPNClassifier::applyNegationPattern(
+                NPNClassifier::applyPermutation(tt, perm), neg, rng() & 1);
+            std::string rep = NPNClassifier::getNPNRepresentative(tt);
+            assert(rep == NPNClassifier::getNPNRepresentative(moved));
+            assert(rep <= tt && rep <= moved);
+        }
+    }
+    
+    std::cout << "  ✓ Kernels match the exhaustive search for n=1..6" << std::endl;
+}
+
+void testShuffleTable() {
+    std::cout << "\nTesting byte-shuffle transform table..." << std::endl;
+    
+    // 384 distinct row permutations, each a bijection on the 16 rows
+    const auto& controls = NPNShuffle::controls();
+    std::set<NPNShuffle::Control> distinct(controls.begin(), controls.end());
+    assert(distinct.size() == NPNShuffle::kInputTransforms);
+    for (const auto& control : controls) {
+        std::set<uint8_t> rows(control.begin(), control.end());
+        assert(rows.size() == 16 && *rows.rbegin() == 15);
+    }
+    
+    // SIMD, scalar gather and the compiled kernel agree on every function
+    for (uint32_t f = 0; f < (1u << 16); ++f) {
+        uint16_t tt = static_cast<uint16_t>(f);
+        uint16_t expected = npn_kernels::Canonizer<4>::minimum(tt);
+        assert(NPNShuffle::minimum(tt) == expected);
+        if (f % 97 == 0) assert(NPNShuffle::minimumScalar(tt) == expected);
+    }
+    
+    std::cout << "  ✓ All 65536 functions agree" << (NPNShuffle::vectorized() ? " (SIMD)" : " (scalar)")
+              << std::endl;
+}
+
+void testWalshSpectrum() {
+    std::cout << "\nTesting Walsh spectrum signatures..." << std::endl;
+    
+    // x1 = row-index bit 2 of a 3-input table: all weight on w = 0b100
+    int16_t spectrum[64];
+    WalshSpectrum::transform(TruthTable::truthTableToBinary("00001111"), 3, spectrum);
+    for (int w = 0; w < 8; ++w) assert(spectrum[w] == (w == 4 ? 8 : 0));
+    // W(0) = rows - 2 * ones, and Parseval: sum of W^2 = rows^2
+    std::mt19937_64 rng(13);
+    uint64_t f = rng();
+    WalshSpectrum::transform(f, 6, spectrum);
+    long energy = 0;
+    for (int w = 0; w < 64; ++w) energy += spectrum[w] * spectrum[w];
+    assert(spectrum[0] == 64 - 2 * __builtin_popcountll(f) && energy == 64 * 64);
+    
+    // Signatures survive every NPN transform
+    for (int n = 2; n <= 6; ++n) {
+        for (int i = 0; i < 20; ++i) {
+            std::string tt = TruthTable::binaryToTruthTable(rng(), n);
+            std::vector<int> perm(n), neg(n);
+            for (int v = 0; v < n; ++v) {
+                perm[v] = v;
+                neg[v] = rng() & 1;
+            }
+            std::shuffle(perm.begin(), perm.end(), rng);
+            std::string moved = NPNClassifier::applyNegationPattern(
+                NPNClassifier::applyPermutation(tt, perm), neg, rng() & 1);
+            assert(WalshSpectrum::signature(TruthTable::truthTableToBinary(tt), n) ==
+                   WalshSpectrum::signature(TruthTable::truthTableToBinary(moved), n));
+        }
+    }
+    
+    // Different signatures only for different classes; over all 4-input
+    // functions the signature separates nearly all of the 222 classes
+    std::set<std::string> reps;
+    std::set<uint64_t> signatures;
+    for (uint64_t g = 0; g < (1 << 16); g += 7) {
+        std::string tt = TruthTable::binaryToTruthTable(g, 4);
+        reps.insert(NPNClassifier::getNPNRepresentative(tt));
+        signatures.insert(WalshSpectrum::signature(g, 4));
+    }
+    assert(signatures.size() <= reps.size() && signatures.size() * 10 >= reps.size() * 8);
+    
+    std::cout << "  ✓ " << signatures.size() << " signatures for " << reps.size() << " classes" << std::endl;
+}
+
+void testBooleanMatching() {
+    std::cout << "\nTesting pairwise Boolean matching..." << std::endl;
+    
+    // Every pair of 3-input functions agrees with canonization, and every
+    // witness maps f onto g
+    NPNTransform transform;
+    for (uint64_t f = 0; f < 256; ++f) {
+        std::string f_tt = TruthTable::binaryToTruthTable(f, 3);
+        for (uint64_t g = 0; g < 256; ++g) {
+            bool matched = NPNMatcher::match(f, g, 3, transform);
+            assert(matched == (NPNClassifier::canonizePacked(f, 3) == NPNClassifier::canonizePacked(g, 3)));
+            if (matched) assert(transform.apply(f_tt) == TruthTable::binaryToTruthTable(g, 3));
+        }
+    }
+    
+    // Random transforms of random 4..6-input functions are found
+    std::mt19937_64 rng(17);
+    for (int n = 4; n <= 6; ++n) {
+        for (int i = 0; i < 50; ++i) {
+            std::string tt = TruthTable::binaryToTruthTable(rng(), n);
+            std::vector<int> perm(n), neg(n);
+            for (int v = 0; v < n; ++v) {
+                perm[v] = v;
+                neg[v] = rng() & 1;
+            }
+            std::shuffle(perm.begin(), perm.end(), rng);
+            std::string moved = NPNClassifier::applyNegationPattern(
+                NPNClassifier::applyPermutation(tt, perm), neg, rng() & 1);
+            bool matched = NPNMatcher::match(tt, moved, transform);
+            assert(matched && transform.apply(tt) == moved);
+        }
+    }
+    
+    // AND and OR share a class through De Morgan; AND and XOR do not
+    bool matched = NPNMatcher::match("0001", "0111", transform);
+    assert(matched && transform.neg_output == 1);
+    assert(transform.neg_inputs == std::vector<int>({1, 1}));
+    assert(!NPNMatcher::match("0001", "0110", transform));
+    assert(!NPNMatcher::match("0001", "00010001", transform));
+    bool threw = false;
+    try {
+        NPNMatcher::match("012", "011", transform);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "  ✓ Matching agrees with canonization and returns valid witnesses" << std::endl;
+}
 
 void testBasicNPN() {
-    std::cout << "Testing basic NPN operations..." << std::endl;
+    std::cout << "\nTesting basic NPN operations..." << std::endl;
     
     // Test constant functions
     assert(NPNClassifier::getNPNRepresentative("0000") == "0000");
@@ -118,8 +430,11 @@ void testSymmetry() {
 void testEquivalence() {
     std::cout << "\nTesting NPN equivalence..." << std::endl;
     
-    // AND and OR should not be equivalent
-    assert(!NPNClassifier::areNPNEquivalent("0001", "0111"));
+    // AND and XOR should not be equivalent
+    assert(!NPNClassifier::areNPNEquivalent("0001", "0110"));
+    
+    // OR(a, b) = ¬AND(¬a, ¬b), so AND and OR share a class
+    assert(NPNClassifier::areNPNEquivalent("0001", "0111"));
     
     // Function should be equivalent to itself
     assert(NPNClassifier::areNPNEquivalent("0001", "0001"));
@@ -132,6 +447,9 @@ int main() {
     std::cout << "NPN CLASSIFICATION TESTS" << std::endl;
     std::cout << std::string(50, '=') << std::endl;
     
+    testTruthTableRange();
+    testWideTruthTable();
+    testSemiCanonicalForm();
     testBasicNPN();
     testPermutation();
     testNegation();
@@ -139,6 +457,10 @@ int main() {
     testNPNClassesN3();
     testSymmetry();
     testEquivalence();
+    testCompiledKernels();
+    testShuffleTable();
+    testWalshSpectrum();
+    testBooleanMatching();
     
     std::cout << "\n" << std::string(50, '=') << std::endl;
     std::cout << "ALL NPN TESTS PASSED ✓" << std::endl;
@@ -1,8 +1,13 @@
 #include <iostream>
 #include <cassert>
 #include <chrono>
+#include <cstdio>
 #include "../src/mig_synthesizer.h"
 #include "../src/mig_structure.h"
+#include "../src/synthesis_cache.h"
+#include "../src/decomposition.h"
+#include "../src/truth_table.h"
+#include <stdexcept>
 
 void testConstants() {
     std::cout << "Testing constant functions..." << std::endl;
@@ -122,6 +127,193 @@ void testComplex3Var() {
     }
 }
 
+void testSymmetryBreaking() {
+    std::cout << "\nTesting symmetry-aware search..." << std::endl;
+    
+    // At least two of four inputs: all inputs are symmetric
+    std::string th2_tt = "0001011101111111";
+    
+    MIGSynthesizer with_symmetry;
+    auto mig = with_symmetry.synthesizeSizeOptimal(th2_tt);
+    
+    MIGSynthesizer without_symmetry;
+    without_symmetry.setSymmetryBreaking(false);
+    auto reference = without_symmetry.synthesizeSizeOptimal(th2_tt);
+    
+    assert(mig != nullptr && reference != nullptr);
+    assert(mig->validate(th2_tt));
+    assert(mig->size() == reference->size());
+    assert(with_symmetry.getStats().symmetry_groups == 1);
+    assert(with_symmetry.getStats().candidates * 4 < without_symmetry.getStats().candidates);
+    
+    std::cout << "  ✓ Size " << mig->size() << " with " << with_symmetry.getStats().candidates
+              << " candidates (" << without_symmetry.getStats().candidates
+              << " without symmetry breaking)" << std::endl;
+}
+
+void testParetoFront() {
+    std::cout << "\nTesting size/depth Pareto front..." << std::endl;
+    
+    for (const std::string tt : {"01101001", "0001011101111111"}) {
+        MIGSynthesizer synthesizer;
+        auto front = synthesizer.synthesizeParetoFront(tt);
+        auto size_optimal = synthesizer.synthesizeSizeOptimal(tt);
+        auto depth_optimal = synthesizer.synthesizeDepthOptimal(tt);
+        
+        assert(!front.empty() && size_optimal && depth_optimal);
+        assert(front.front()->size() == size_optimal->size());
+        assert(front.back()->depth() == depth_optimal->depth());
+        for (size_t i = 0; i < front.size(); ++i) {
+            assert(front[i]->validate(tt));
+            if (i > 0) {
+                assert(front[i]->size() > front[i - 1]->size());
+                assert(front[i]->depth() < front[i - 1]->depth());
+            }
+        }
+        std::cout << "  ✓ " << tt << ": " << front.size() << " point(s), depth-optimal Size: "
+                  << depth_optimal->size() << ", Depth: " << depth_optimal->depth() << std::endl;
+    }
+}
+
+void testFullAdder() {
+    std::cout << "\nTesting multi-output full adder synthesis..." << std::endl;
+    
+    // Sum = x1 ⊕ x2 ⊕ x3, carry = MAJ(x1, x2, x3)
+    std::vector<std::string> outputs = {"01101001", "00010111"};
+    auto start = std::chrono::high_resolution_clock::now();
+    auto mig = synthesizeMultiOutputMIG(outputs);
+    auto end = std::chrono::high_resolution_clock::now();
+    double synthesis_time = std::chrono::duration<double>(end - start).count();
+    
+    assert(mig != nullptr);
+    assert(mig->numOutputs() == 2);
+    assert(mig->validate(outputs));
+    // Sharing the carry gate saves one gate over separate synthesis (3 + 1)
+    assert(mig->size() == 3);
+    
+    std::cout << "  ✓ Full adder synthesized in " << synthesis_time << "s" << std::endl;
+    std::cout << "  Size: " << mig->size() << ", Depth: " << mig->depth() << std::endl;
+}
+
+void testSynthesisCache() {
+    std::cout << "\nTesting persistent synthesis cache..." << std::endl;
+    
+    const std::string log_path = "test_cache/synthesis_cache.log";
+    // At least two of four inputs: about 45k candidates
+    const std::string th2_tt = "0001011101111111";
+    std::remove(log_path.c_str());
+    
+    {
+        SynthesisCache cache(log_path);
+        auto mig = cache.getOrSynthesize("00010111");
+        assert(mig != nullptr && mig->validate("00010111"));
+        cache.getOrSynthesize("00010111");
+        assert(cache.misses() == 1 && cache.hits() == 1);
+        
+        // No budget: a candidate limit well below the ~45k the search
+        // needs stops it before the first deadline check
+        SynthesisCache impatient(log_path, 0);
+        impatient.setCandidateLimit(1000);
+        assert(impatient.getOrSynthesize(th2_tt) == nullptr);
+    }
+    
+    // Replayed from the log
+    SynthesisCache cache(log_path);
+    SynthesisCache::Entry entry;
+    assert(cache.lookup("00010111", entry));
+    assert(entry.status == SynthesisCache::Status::Optimal && entry.mig->size() == 1);
+    assert(cache.lookup(th2_tt, entry));
+    assert(entry.status == SynthesisCache::Status::Timeout && entry.budget_ms == 0);
+    
+    // A cache with a larger budget retries the timeout and upgrades it
+    auto mig = cache.getOrSynthesize(th2_tt);
+    assert(mig != nullptr && mig->validate(th2_tt) && mig->size() == 4 && cache.misses() == 1);
+    assert(cache.lookup(th2_tt, entry) && entry.status == SynthesisCache::Status::Optimal);
+    mig = cache.getOrSynthesize("01101001");
+    assert(mig != nullptr && cache.misses() == 2);
+    
+    SynthesisCache replayed(log_path);
+    assert(replayed.lookup(th2_tt, entry));
+    assert(entry.status == SynthesisCache::Status::Optimal && entry.mig->size() == 4);
+    std::remove(log_path.c_str());
+    std::remove("test_cache");
+    
+    std::cout << "  ✓ Cache hits, replay and timeout upgrades work" << std::endl;
+}
+
+void testDecomposition() {
+    std::cout << "\nTesting disjoint-support decomposition..." << std::endl;
+    
+    // MAJ(x1, x2, x3) ∧ MAJ(x4, x5, x6)
+    std::string tt = "0000000000000000000000000001011100000000000101110001011100010111";
+    DisjointDecomposition dec;
+    assert(Decomposer::findDisjointDecomposition(tt, dec));
+    assert((dec.bound_vars == std::vector<int>{0, 1, 2}));
+    assert(dec.inner == "00010111");
+    
+    auto mig = Decomposer::synthesize(tt);
+    assert(mig != nullptr && mig->validate(tt));
+    std::cout << "  ✓ 6-input MAJ ∧ MAJ composed from blocks, Size: " << mig->size() << std::endl;
+    
+    // MAJ-5 has no disjoint-support decomposition
+    std::string maj5_tt = "00000001000101110001011101111111";
+    assert(!Decomposer::findDisjointDecomposition(maj5_tt, dec));
+    
+    // Top-level decomposition: x1 ∧ ¬x4 only depends on two variables
+    std::vector<int> support;
+    assert(Decomposer::shrinkToSupport("0000000010101010", support) == "0010");
+    assert((support == std::vector<int>{0, 3}));
+    
+    std::cout << "  ✓ Decomposition checks passed" << std::endl;
+}
+
+void testUpperBound() {
+    std::cout << "\nTesting Shannon upper bounds and bounded search..." << std::endl;
+    
+    // Every 3-input function: the bound is valid and the bounded search
+    // still finds the optimum
+    for (int f = 0; f < 256; ++f) {
+        std::string tt = TruthTable::binaryToTruthTable(f, 3);
+        auto bound = Decomposer::shannonUpperBound(tt);
+        assert(bound != nullptr && bound->validate(tt));
+        MIGSynthesizer synthesizer;
+        auto mig = synthesizer.synthesizeSizeOptimal(tt, *bound);
+        assert(mig->validate(tt) && !synthesizer.getStats().timed_out);
+        assert(mig->size() == synthesizeOptimalMIG(tt)->size());
+    }
+    
+    // AND5 = x1 ∧ AND4 costs one gate on top of its cofactor, which is already
+    // optimal, so the bounded search only has to rule out smaller sizes
+    std::string and5_tt(32, '0');
+    and5_tt[31] = '1';
+    auto bound = Decomposer::shannonUpperBound(and5_tt);
+    assert(bound->size() == 4);
+    MIGSynthesizer bounded, plain;
+    auto mig = bounded.synthesizeSizeOptimal(and5_tt, *bound);
+    auto reference = plain.synthesizeSizeOptimal(and5_tt);
+    assert(mig->size() == reference->size() && bounded.getStats().upper_bound == 4);
+    uint64_t bounded_candidates = bounded.getStats().candidates;
+    assert(bounded_candidates < plain.getStats().candidates);
+    
+    // Out of time, the bound is still an answer
+    std::string hard_tt = "00000000000000000001000000001100";
+    bound = Decomposer::shannonUpperBound(hard_tt);
+    MIGSynthesizer no_time(0);
+    mig = no_time.synthesizeSizeOptimal(hard_tt, *bound);
+    assert(mig != nullptr && mig->validate(hard_tt) && no_time.getStats().timed_out);
+    
+    bool threw = false;
+    try {
+        bounded.synthesizeSizeOptimal(hard_tt, *reference);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "  ✓ AND5 bounded search: " << bounded_candidates << " candidates ("
+              << plain.getStats().candidates << " without a bound)" << std::endl;
+}
+
 void testValidation() {
     std::cout << "\nTesting MIG validation..." << std::endl;
     
@@ -150,6 +342,12 @@ int main() {
     testXORGate();
     testMAJ3();
     testComplex3Var();
+    testSymmetryBreaking();
+    testParetoFront();
+    testFullAdder();
+    testSynthesisCache();
+    testDecomposition();
+    testUpperBound();
     testValidation();
     
     std::cout << "\n" << std::string(50, '=') << std::endl;